@@ -0,0 +1,178 @@
+/******************************************************************************/
+/* GLCD_List.c: Recorded GLCD display list                                    */
+/*   Producers append commands at the tail (serialised by the caller), the    */
+/*   replaying task consumes from the head. The head is only written by the  */
+/*   replaying task, so a producer reading a stale head at worst sees the     */
+/*   ring as fuller than it is.                                               */
+/******************************************************************************/
+
+#include <string.h>
+#include "GLCD.h"
+#include "GLCD_List.h"
+
+/*---------------------------- Global variables ------------------------------*/
+
+static GLCD_Cmd              list[GLCD_LIST_SIZE];
+static volatile unsigned int list_head;         /* Next command to replay     */
+static volatile unsigned int list_tail;         /* Next free slot             */
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Claim the slot at the tail of the ring                                       *
+*   Parameter:    type:   command type                                         *
+*   Return:               command to fill in, 0 if the ring is full            *
+*******************************************************************************/
+
+static GLCD_Cmd *list_alloc (unsigned char type) {
+  GLCD_Cmd *cmd;
+
+  if (list_tail - list_head >= GLCD_LIST_SIZE) {
+    return (0);
+  }
+  cmd = &list[list_tail % GLCD_LIST_SIZE];
+  memset(cmd, 0, sizeof(GLCD_Cmd));
+  cmd->type = type;
+  return (cmd);
+}
+
+
+/*******************************************************************************
+* Publish the command claimed by list_alloc                                    *
+*   Parameter:                                                                 *
+*   Return:               1                                                    *
+*******************************************************************************/
+
+static __inline int list_commit (void) {
+
+  list_tail++;
+  return (1);
+}
+
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Record a display clear                                                       *
+*   Parameter:      color:    display clearing color                           *
+*   Return:                   1 if recorded, 0 if the ring is full             *
+*******************************************************************************/
+
+int GLCD_Cmd_Clear (unsigned short color) {
+  GLCD_Cmd *cmd = list_alloc(GLCD_CMD_CLEAR);
+
+  if (cmd == 0) return (0);
+  cmd->color = color;
+  return (list_commit());
+}
+
+
+/*******************************************************************************
+* Record a bitmap, the bitmap is not copied                                    *
+*   Parameter:      x:        horizontal position                              *
+*                   y:        vertical position                                *
+*                   w:        width of bitmap                                  *
+*                   h:        height of bitmap                                 *
+*                   bitmap:   address at which the bitmap data resides         *
+*   Return:                   1 if recorded, 0 if the ring is full             *
+*******************************************************************************/
+
+int GLCD_Cmd_Bitmap (unsigned int x, unsigned int y, unsigned int w, unsigned int h,
+                     const unsigned short *bitmap) {
+  GLCD_Cmd *cmd = list_alloc(GLCD_CMD_BITMAP);
+
+  if (cmd == 0) return (0);
+  cmd->x      = x;
+  cmd->y      = y;
+  cmd->w      = w;
+  cmd->h      = h;
+  cmd->bitmap = bitmap;
+  return (list_commit());
+}
+
+
+/*******************************************************************************
+* Record a string on given line, the string is copied (and truncated)         *
+*   Parameter:      ln:       line number                                      *
+*                   col:      column number                                    *
+*                   fi:       font index (0 = 6x8, 1 = 16x24)                  *
+*                   color:    text color                                       *
+*                   back:     background color                                 *
+*                   s:        pointer to string                                *
+*   Return:                   1 if recorded, 0 if the ring is full             *
+*******************************************************************************/
+
+int GLCD_Cmd_Text (unsigned int ln, unsigned int col, unsigned char fi,
+                   unsigned short color, unsigned short back, const char *s) {
+  GLCD_Cmd *cmd = list_alloc(GLCD_CMD_TEXT);
+
+  if (cmd == 0) return (0);
+  cmd->x     = col;
+  cmd->y     = ln;
+  cmd->font  = fi;
+  cmd->color = color;
+  cmd->back  = back;
+  strncpy(cmd->text, s, GLCD_LIST_TEXT - 1);
+  return (list_commit());
+}
+
+
+/*******************************************************************************
+* Number of commands recorded and not yet replayed, taken under the same lock  *
+* as the producers to hand the commands over                                   *
+*   Parameter:                                                                 *
+*   Return:                   number of pending commands                       *
+*******************************************************************************/
+
+unsigned int GLCD_List_Pending (void) {
+
+  return (list_tail - list_head);
+}
+
+
+/*******************************************************************************
+* Inspect a pending command                                                    *
+*   Parameter:      i:        index from the oldest pending command            *
+*   Return:                   command, 0 if there is no such command           *
+*******************************************************************************/
+
+const GLCD_Cmd *GLCD_List_Peek (unsigned int i) {
+
+  if (i >= list_tail - list_head) {
+    return (0);
+  }
+  return (&list[(list_head + i) % GLCD_LIST_SIZE]);
+}
+
+
+/*******************************************************************************
+* Replay the oldest pending commands to the GLCD                               *
+*   Parameter:      n:        number of commands, from GLCD_List_Pending       *
+*   Return:                   number of display clears replayed                *
+*******************************************************************************/
+
+unsigned int GLCD_List_Replay (unsigned int n) {
+  GLCD_Cmd *cmd;
+  unsigned int clears = 0;
+
+  while (n--) {
+    cmd = &list[list_head % GLCD_LIST_SIZE];
+    switch (cmd->type) {
+      case GLCD_CMD_CLEAR:
+        GLCD_Clear(cmd->color);
+        clears++;
+        break;
+      case GLCD_CMD_BITMAP:
+        GLCD_Bitmap(cmd->x, cmd->y, cmd->w, cmd->h, (unsigned char *)cmd->bitmap);
+        break;
+      case GLCD_CMD_TEXT:
+        GLCD_SetTextColor(cmd->color);
+        GLCD_SetBackColor(cmd->back);
+        GLCD_DisplayString(cmd->y, cmd->x, cmd->font, (unsigned char *)cmd->text);
+        break;
+    }
+    list_head++;
+  }
+  return (clears);
+}
+/******************************************************************************/
@@ -0,0 +1,43 @@
+/******************************************************************************/
+/* GLCD_List.h: Recorded GLCD display list                                    */
+/*   Draw commands are appended to a fixed-size ring without touching the    */
+/*   bus, and replayed to the GLCD by a single task. Appending must be        */
+/*   serialised by the caller; replaying needs no lock.                       */
+/******************************************************************************/
+
+#ifndef _GLCD_LIST_H
+#define _GLCD_LIST_H
+
+#define GLCD_LIST_SIZE  32              /* Commands held in the ring          */
+#define GLCD_LIST_TEXT  24              /* Max. text length incl. terminator  */
+
+/* Command types                                                              */
+#define GLCD_CMD_CLEAR  0               /* Clear the display                  */
+#define GLCD_CMD_BITMAP 1               /* Draw a bitmap (bottom row first)   */
+#define GLCD_CMD_TEXT   2               /* Display a string                   */
+
+typedef struct {
+  unsigned char         type;           /* GLCD_CMD_xxx                       */
+  unsigned char         font;           /* TEXT: font index                   */
+  unsigned short        x, y;           /* TEXT: column and line              */
+  unsigned short        w, h;
+  unsigned short        color;          /* CLEAR: color, TEXT: text           */
+  unsigned short        back;           /* TEXT: background color             */
+  const unsigned short *bitmap;         /* BITMAP: must stay valid until      */
+                                        /* replayed and GLCD_Busy() is 0      */
+  char                  text[GLCD_LIST_TEXT];
+} GLCD_Cmd;
+
+/* Recording, each returns 0 if the ring is full                              */
+extern int             GLCD_Cmd_Clear   (unsigned short color);
+extern int             GLCD_Cmd_Bitmap  (unsigned int x, unsigned int y, unsigned int w, unsigned int h,
+                                         const unsigned short *bitmap);
+extern int             GLCD_Cmd_Text    (unsigned int ln, unsigned int col, unsigned char fi,
+                                         unsigned short color, unsigned short back, const char *s);
+
+/* Hand-off and replay                                                        */
+extern unsigned int    GLCD_List_Pending (void);
+extern const GLCD_Cmd *GLCD_List_Peek    (unsigned int i);
+extern unsigned int    GLCD_List_Replay  (unsigned int n);
+
+#endif /* _GLCD_LIST_H */
@@ -1,928 +1,1308 @@
-/******************************************************************************/
-/* GLCD_SPI_LPC1700.c: LPC1700 low level Graphic LCD (240x320 pixels) driven  */
-/*                     with SPI functions                                     */
-/******************************************************************************/
-/* This file is part of the uVision/ARM development tools.                    */
-/* Copyright (c) 2005-2011 Keil - An ARM Company. All rights reserved.        */
-/* This software may only be used under the terms of a valid, current,        */
-/* end user licence from KEIL for a compatible version of KEIL software       */
-/* development tools. Nothing else gives you the right to use this software.  */
-/******************************************************************************/
-
-
-#include <lpc17xx.h>
-#include "GLCD.h"
-#include "Font_6x8_h.h"
-#include "Font_16x24_h.h"
-
-/************************** Orientation  configuration ************************/
-
-#define LANDSCAPE   0                   /* 1 for landscape, 0 for portrait    */
-#define ROTATE180   0                   /* 1 to rotate the screen for 180 deg */
-
-/*********************** Hardware specific configuration **********************/
-
-/* SPI Interface: SPI3
-   
-   PINS: 
-   - CS     = P0.6 (GPIO pin)
-   - RS     = GND
-   - WR/SCK = P0.7 (SCK1)
-   - RD     = GND
-   - SDO    = P0.8 (MISO1)
-   - SDI    = P0.9 (MOSI1)                                                    */
-
-#define PIN_CS      (1 << 6)
-#define PIN_CLK     (1 << 7)
-#define PIN_DAT     (1 << 9)
-
-#define IN          0x00
-#define OUT         0x01
-
-/* SPI_SR - bit definitions                                                   */
-#define TFE         0x01
-#define RNE         0x04
-#define BSY         0x10
-
-/*------------------------- Speed dependant settings -------------------------*/
-
-/* If processor works on high frequency delay has to be increased, it can be 
-   increased by factor 2^N by this constant                                   */
-#define DELAY_2N    18
-
-/*---------------------- Graphic LCD size definitions ------------------------*/
-
-#if (LANDSCAPE == 1)
-#define WIDTH       320                 /* Screen Width (in pixels)           */
-#define HEIGHT      240                 /* Screen Hight (in pixels)           */
-#else
-#define WIDTH       240                 /* Screen Width (in pixels)           */
-#define HEIGHT      320                 /* Screen Hight (in pixels)           */
-#endif
-#define BPP         16                  /* Bits per pixel                     */
-#define BYPP        ((BPP+7)/8)         /* Bytes per pixel                    */
-
-/*--------------- Graphic LCD interface hardware definitions -----------------*/
-
-/* Pin CS setting to 0 or 1                                                   */
-#define LCD_CS(x)   ((x) ? (LPC_GPIO0->FIOSET = PIN_CS)    : (LPC_GPIO0->FIOCLR = PIN_CS))
-#define LCD_CLK(x)  ((x) ? (LPC_GPIO0->FIOSET = PIN_CLK)   : (LPC_GPIO0->FIOCLR = PIN_CLK))
-#define LCD_DAT(x)  ((x) ? (LPC_GPIO0->FIOSET = PIN_DAT)   : (LPC_GPIO0->FIOCLR = PIN_DAT))
-
-#define DAT_MODE(x) ((x == OUT) ? (LPC_GPIO0->FIODIR |= PIN_DAT) : (LPC_GPIO0->FIODIR &= ~PIN_DAT))
-#define BUS_VAL()                ((LPC_GPIO0->FIOPIN  & PIN_DAT) != 0)
-
-
-#define SPI_START   (0x70)              /* Start byte for SPI transfer        */
-#define SPI_RD      (0x01)              /* WR bit 1 within start              */
-#define SPI_WR      (0x00)              /* WR bit 0 within start              */
-#define SPI_DATA    (0x02)              /* RS bit 1 within start byte         */
-#define SPI_INDEX   (0x00)              /* RS bit 0 within start byte         */
-
-#define BG_COLOR  0                     /* Background color                   */
-#define TXT_COLOR 1                     /* Text color                         */
-
- 
-/*---------------------------- Global variables ------------------------------*/
-
-/******************************************************************************/
-static volatile unsigned short Color[2] = {White, Black};
-static unsigned char Himax;
-
-/************************ Local auxiliary functions ***************************/
-
-/*******************************************************************************
-* Delay in while loop cycles                                                   *
-*   Parameter:    cnt:    number of while cycles to delay                      *
-*   Return:                                                                    *
-*******************************************************************************/
-
-static void delay (int cnt) {
-  cnt <<= DELAY_2N;
-  while (cnt--);
-}
-
-
-/*******************************************************************************
-* Transfer 1 byte over the serial communication                                *
-*   Parameter:    byte:   byte to be sent                                      *
-*                 mode:   OUT = transmit byte, IN = receive byte               *
-*   Return:               byte read while sending                              *
-*******************************************************************************/
-static unsigned char spi_tran_man (unsigned char byte, unsigned int mode) {
-  unsigned char val = 0;
-  int i;
-
-  if (mode == OUT) { DAT_MODE (OUT); }
-  else             { DAT_MODE (IN);  }
-
-  for (i = 7; i >= 0; i--) {
-    LCD_CLK(0);
-    delay(1);
-    if (mode == OUT) {
-      LCD_DAT((byte & (1 << i)) != 0);
-    }
-    else {
-      val |= (BUS_VAL() << i);
-    }
-    LCD_CLK(1);
-    delay(1);
-  }
-  return (val);
-}
-
-
-/*******************************************************************************
-* Transfer 1 byte over the serial communication                                *
-*   Parameter:    byte:   byte to be sent                                      *
-*   Return:               byte read while sending                              *
-*******************************************************************************/
-
-static __inline unsigned char spi_tran (unsigned char byte) {
-
-  LPC_SSP1->DR = byte;
-  while (!(LPC_SSP1->SR & RNE));        /* Wait for send to finish            */
-  return (LPC_SSP1->DR);
-}
-
-
-/*******************************************************************************
-* Write a command the LCD controller                                           *
-*   Parameter:    cmd:    command to be written                                *
-*   Return:                                                                    *
-*******************************************************************************/
-
-static __inline void wr_cmd (unsigned char cmd) {
-  LCD_CS(0);
-  spi_tran(SPI_START | SPI_WR | SPI_INDEX);   /* Write : RS = 0, RW = 0       */
-  spi_tran(0);
-  spi_tran(cmd);
-  LCD_CS(1);
-}
-
-
-/*******************************************************************************
-* Write data to the LCD controller                                             *
-*   Parameter:    dat:    data to be written                                   *
-*   Return:                                                                    *
-*******************************************************************************/
-
-static __inline void wr_dat (unsigned short dat) {
-  LCD_CS(0);
-  spi_tran(SPI_START | SPI_WR | SPI_DATA);    /* Write : RS = 1, RW = 0       */
-  spi_tran((dat >>   8));                     /* Write D8..D15                */
-  spi_tran((dat & 0xFF));                     /* Write D0..D7                 */
-  LCD_CS(1);
-}
-
-
-/*******************************************************************************
-* Start of data writing to the LCD controller                                  *
-*   Parameter:                                                                 *
-*   Return:                                                                    *
-*******************************************************************************/
-
-static __inline void wr_dat_start (void) {
-  LCD_CS(0);
-  spi_tran(SPI_START | SPI_WR | SPI_DATA);    /* Write : RS = 1, RW = 0       */
-}
-
-
-/*******************************************************************************
-* Stop of data writing to the LCD controller                                   *
-*   Parameter:                                                                 *
-*   Return:                                                                    *
-*******************************************************************************/
-
-static __inline void wr_dat_stop (void) {
-
-  LCD_CS(1);
-}
-
-
-/*******************************************************************************
-* Data writing to the LCD controller                                           *
-*   Parameter:    dat:    data to be written                                   *
-*   Return:                                                                    *
-*******************************************************************************/
-
-static __inline void wr_dat_only (unsigned short dat) {
-
-  spi_tran((dat >>   8));                     /* Write D8..D15                */
-  spi_tran((dat & 0xFF));                     /* Write D0..D7                 */
-}
-
-
-/*******************************************************************************
-* Read data from the LCD controller                                            *
-*   Parameter:                                                                 *
-*   Return:               read data                                            *
-*******************************************************************************/
-
-static __inline unsigned short rd_dat (void) {
-  unsigned short val = 0;
-
-  LCD_CS(0);
-  spi_tran(SPI_START | SPI_RD | SPI_DATA);    /* Read: RS = 1, RW = 1         */
-  spi_tran(0);                                /* Dummy read 1                 */  
-  val   = spi_tran(0);                        /* Read D8..D15                 */
-  val <<= 8;
-  val  |= spi_tran(0);                        /* Read D0..D7                  */
-  LCD_CS(1);
-  return (val);
-}
-
-
-/*******************************************************************************
-* Write a value to the to LCD register                                         *
-*   Parameter:    reg:    register to be written                               *
-*                 val:    value to write to the register                       *
-*******************************************************************************/
-
-static __inline void wr_reg (unsigned char reg, unsigned short val) {
-
-  wr_cmd(reg);
-  wr_dat(val);
-}
-
-
-/*******************************************************************************
-* Read from the LCD register                                                   *
-*   Parameter:    reg:    register to be read                                  *
-*   Return:               value read from the register                         *
-*******************************************************************************/
-
-static unsigned short rd_reg (unsigned char reg) {
-
-  wr_cmd(reg);
-  return(rd_dat());
-}
-
-
-/*******************************************************************************
-* Read LCD controller ID (Himax GLCD)                                          *
-*   Parameter:    (none)                                                       *
-*   Return:       controller ID                                                *
-*******************************************************************************/
-
-static unsigned short rd_id_man (void) {
-  unsigned short val;
-
-  /* Set MOSI, MISO and SCK as GPIO pins, with pull-down/pull-up disabled     */
-  LPC_PINCON->PINSEL0  &= ~((3 << 18) | (3 << 16) | (3 << 14));
-  LPC_PINCON->PINMODE0 |= 0x000AA000;
-  LPC_GPIO0->FIODIR    |= PIN_CLK;      /* SCK pin is GPIO output             */
-  LCD_CS (1);                           /* Set chip select high               */
-  LCD_CLK(1);                           /* Set clock high                     */
-
-  LCD_CS(0);
-  spi_tran_man (SPI_START | SPI_WR | SPI_INDEX, OUT);
-  spi_tran_man (0x00, OUT);
-  LCD_CS(1);
-
-  LCD_CS(0);
-  spi_tran_man (SPI_START | SPI_RD | SPI_DATA, OUT);
-  val = spi_tran_man(0, IN);
-  LCD_CS(1);
-
-  /* Connect MOSI, MISO, and SCK to SSP peripheral                            */
-  LPC_GPIO0->FIODIR    &= ~PIN_CLK;
-  LPC_PINCON->PINSEL0  |= (2 << 18) | (2 << 16) | (2 << 14);
-  LPC_PINCON->PINMODE0 &= ~0x000FF000;
-
-  return (val);
-}
-
-
-/************************ Exported functions **********************************/
-
-/*******************************************************************************
-* Initialize the Graphic LCD controller                                        *
-*   Parameter:                                                                 *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_Init (void) {
-  unsigned short driverCode;
-
-  /* Enable clock for SSP1, clock = CCLK / 2                                  */
-  LPC_SC->PCONP       |= 0x00000400;
-  LPC_SC->PCLKSEL0    |= 0x00200000;
-
-  /* Configure the LCD Control pins                                           */
-  LPC_PINCON->PINSEL9 &= 0xF0FFFFFF;
-  LPC_GPIO4->FIODIR   |= 0x30000000;
-  LPC_GPIO4->FIOSET    = 0x20000000;
-
-  /* SSEL1 is GPIO output set to high                                         */
-  LPC_GPIO0->FIODIR   |= 0x00000040;
-  LPC_GPIO0->FIOSET    = 0x00000040;
-  LPC_PINCON->PINSEL0 &= 0xFFF03FFF;
-  LPC_PINCON->PINSEL0 |= 0x000A8000;
-
-  /* Enable SPI in Master Mode, CPOL=1, CPHA=1                                */
-  /* Max. 12.5 MBit used for Data Transfer @ 100MHz                           */
-  LPC_SSP1->CR0        = 0x01C7;
-  LPC_SSP1->CPSR       = 0x02;
-  LPC_SSP1->CR1        = 0x02;
-  
-  driverCode = rd_id_man ();
-  if (driverCode == 0) {
-    driverCode = rd_reg(0x00);
-  }
-
-  if (driverCode == 0x47) {             /* LCD with HX8347-D LCD Controller   */
-    Himax = 1;                          /* Set Himax LCD controller flag      */
-    /* Driving ability settings ----------------------------------------------*/
-    wr_reg(0xEA, 0x00);                 /* Power control internal used (1)    */
-    wr_reg(0xEB, 0x20);                 /* Power control internal used (2)    */
-    wr_reg(0xEC, 0x0C);                 /* Source control internal used (1)   */
-    wr_reg(0xED, 0xC7);                 /* Source control internal used (2)   */
-    wr_reg(0xE8, 0x38);                 /* Source output period Normal mode   */
-    wr_reg(0xE9, 0x10);                 /* Source output period Idle mode     */
-    wr_reg(0xF1, 0x01);                 /* RGB 18-bit interface ;0x0110       */
-    wr_reg(0xF2, 0x10);
-
-    /* Adjust the Gamma Curve ------------------------------------------------*/
-    wr_reg(0x40, 0x01);
-    wr_reg(0x41, 0x00);
-    wr_reg(0x42, 0x00);
-    wr_reg(0x43, 0x10);
-    wr_reg(0x44, 0x0E);
-    wr_reg(0x45, 0x24);
-    wr_reg(0x46, 0x04);
-    wr_reg(0x47, 0x50);
-    wr_reg(0x48, 0x02);
-    wr_reg(0x49, 0x13);
-    wr_reg(0x4A, 0x19);
-    wr_reg(0x4B, 0x19);
-    wr_reg(0x4C, 0x16);
-
-    wr_reg(0x50, 0x1B);
-    wr_reg(0x51, 0x31);
-    wr_reg(0x52, 0x2F);
-    wr_reg(0x53, 0x3F);
-    wr_reg(0x54, 0x3F);
-    wr_reg(0x55, 0x3E);
-    wr_reg(0x56, 0x2F);
-    wr_reg(0x57, 0x7B);
-    wr_reg(0x58, 0x09);
-    wr_reg(0x59, 0x06);
-    wr_reg(0x5A, 0x06);
-    wr_reg(0x5B, 0x0C);
-    wr_reg(0x5C, 0x1D);
-    wr_reg(0x5D, 0xCC);
-
-    /* Power voltage setting -------------------------------------------------*/
-    wr_reg(0x1B, 0x1B);
-    wr_reg(0x1A, 0x01);
-    wr_reg(0x24, 0x2F);
-    wr_reg(0x25, 0x57);
-    wr_reg(0x23, 0x88);
-
-    /* Power on setting ------------------------------------------------------*/
-    wr_reg(0x18, 0x36);                 /* Internal oscillator frequency adj  */
-    wr_reg(0x19, 0x01);                 /* Enable internal oscillator         */
-    wr_reg(0x01, 0x00);                 /* Normal mode, no scrool             */
-    wr_reg(0x1F, 0x88);                 /* Power control 6 - DDVDH Off        */
-    delay(20);
-    wr_reg(0x1F, 0x82);                 /* Power control 6 - Step-up: 3 x VCI */
-    delay(5);
-    wr_reg(0x1F, 0x92);                 /* Power control 6 - Step-up: On      */
-    delay(5);
-    wr_reg(0x1F, 0xD2);                 /* Power control 6 - VCOML active     */
-    delay(5);
-
-    /* Color selection -------------------------------------------------------*/
-    wr_reg(0x17, 0x55);                 /* RGB, System interface: 16 Bit/Pixel*/
-    wr_reg(0x00, 0x00);                 /* Scrolling off, no standby          */
-
-    /* Interface config ------------------------------------------------------*/
-    wr_reg(0x2F, 0x11);                 /* LCD Drive: 1-line inversion        */
-    wr_reg(0x31, 0x00);
-    wr_reg(0x32, 0x00);                 /* DPL=0, HSPL=0, VSPL=0, EPL=0       */
-
-    /* Display on setting ----------------------------------------------------*/
-    wr_reg(0x28, 0x38);                 /* PT(0,0) active, VGL/VGL            */
-    delay(20);
-    wr_reg(0x28, 0x3C);                 /* Display active, VGL/VGL            */
-
-   #if (LANDSCAPE == 1)
-    #if (ROTATE180 == 0)
-     wr_reg (0x16, 0xA8);
-    #else
-     wr_reg (0x16, 0x68);
-    #endif
-   #else
-    #if (ROTATE180 == 0)
-     wr_reg (0x16, 0x08);
-    #else
-     wr_reg (0x16, 0xC8);
-    #endif
-   #endif
-
-    /* Display scrolling settings --------------------------------------------*/
-    wr_reg(0x0E, 0x00);                 /* TFA MSB                            */
-    wr_reg(0x0F, 0x00);                 /* TFA LSB                            */
-    wr_reg(0x10, 320 >> 8);             /* VSA MSB                            */
-    wr_reg(0x11, 320 &  0xFF);          /* VSA LSB                            */
-    wr_reg(0x12, 0x00);                 /* BFA MSB                            */
-    wr_reg(0x13, 0x00);                 /* BFA LSB                            */
-  }
-  else {
-    Himax = 0;                          /* This is not Himax LCD controller   */
-    /* Start Initial Sequence ------------------------------------------------*/
-   #if (ROTATE180 == 1)
-    wr_reg(0x01, 0x0000);               /* Clear SS bit                       */
-   #else
-    wr_reg(0x01, 0x0100);               /* Set SS bit                         */
-   #endif
-    wr_reg(0x02, 0x0700);               /* Set 1 line inversion               */
-    wr_reg(0x04, 0x0000);               /* Resize register                    */
-    wr_reg(0x08, 0x0207);               /* 2 lines front, 7 back porch        */
-    wr_reg(0x09, 0x0000);               /* Set non-disp area refresh cyc ISC  */
-    wr_reg(0x0A, 0x0000);               /* FMARK function                     */
-    wr_reg(0x0C, 0x0000);               /* RGB interface setting              */
-    wr_reg(0x0D, 0x0000);               /* Frame marker Position              */
-    wr_reg(0x0F, 0x0000);               /* RGB interface polarity             */
-
-    /* Power On sequence -----------------------------------------------------*/
-    wr_reg(0x10, 0x0000);               /* Reset Power Control 1              */
-    wr_reg(0x11, 0x0000);               /* Reset Power Control 2              */
-    wr_reg(0x12, 0x0000);               /* Reset Power Control 3              */
-    wr_reg(0x13, 0x0000);               /* Reset Power Control 4              */
-    delay(20);                          /* Discharge cap power voltage (200ms)*/
-    wr_reg(0x10, 0x12B0);               /* SAP, BT[3:0], AP, DSTB, SLP, STB   */
-    wr_reg(0x11, 0x0007);               /* DC1[2:0], DC0[2:0], VC[2:0]        */
-    delay(5);                           /* Delay 50 ms                        */
-    wr_reg(0x12, 0x01BD);               /* VREG1OUT voltage                   */
-    delay(5);                           /* Delay 50 ms                        */
-    wr_reg(0x13, 0x1400);               /* VDV[4:0] for VCOM amplitude        */
-    wr_reg(0x29, 0x000E);               /* VCM[4:0] for VCOMH                 */
-    delay(5);                           /* Delay 50 ms                        */
-    wr_reg(0x20, 0x0000);               /* GRAM horizontal Address            */
-    wr_reg(0x21, 0x0000);               /* GRAM Vertical Address              */
-
-    /* Adjust the Gamma Curve ------------------------------------------------*/
-    switch (driverCode) {
-      case 0x5408:                      /* LCD with SPFD5408 LCD Controller   */
-        wr_reg(0x30, 0x0B0D);
-        wr_reg(0x31, 0x1923);
-        wr_reg(0x32, 0x1C26);
-        wr_reg(0x33, 0x261C);
-        wr_reg(0x34, 0x2419);
-        wr_reg(0x35, 0x0D0B);
-        wr_reg(0x36, 0x1006);
-        wr_reg(0x37, 0x0610);
-        wr_reg(0x38, 0x0706);
-        wr_reg(0x39, 0x0304);
-        wr_reg(0x3A, 0x0E05);
-        wr_reg(0x3B, 0x0E01);
-        wr_reg(0x3C, 0x010E);
-        wr_reg(0x3D, 0x050E);
-        wr_reg(0x3E, 0x0403);
-        wr_reg(0x3F, 0x0607);
-        break;
-
-      case 0x9325:                      /* LCD with RM68050 LCD Controller    */
-        wr_reg(0x0030,0x0000);
-        wr_reg(0x0031,0x0607);
-        wr_reg(0x0032,0x0305);
-        wr_reg(0x0035,0x0000);
-        wr_reg(0x0036,0x1604);
-        wr_reg(0x0037,0x0204);
-        wr_reg(0x0038,0x0001);
-        wr_reg(0x0039,0x0707);
-        wr_reg(0x003C,0x0000);
-        wr_reg(0x003D,0x000F);
-        break;
-
-      case 0x9320:                      /* LCD with ILI9320 LCD Controller    */
-      default:                          /* LCD with other LCD Controller      */
-        wr_reg(0x30, 0x0006);
-        wr_reg(0x31, 0x0101);
-        wr_reg(0x32, 0x0003);
-        wr_reg(0x35, 0x0106);
-        wr_reg(0x36, 0x0B02);
-        wr_reg(0x37, 0x0302);
-        wr_reg(0x38, 0x0707);
-        wr_reg(0x39, 0x0007);
-        wr_reg(0x3C, 0x0600);
-        wr_reg(0x3D, 0x020B);
-        break;
-    }
-
-    /* Set GRAM area ---------------------------------------------------------*/
-    wr_reg(0x50, 0x0000);               /* Horizontal GRAM Start Address      */
-    wr_reg(0x51, (HEIGHT-1));           /* Horizontal GRAM End   Address      */
-    wr_reg(0x52, 0x0000);               /* Vertical   GRAM Start Address      */
-    wr_reg(0x53, (WIDTH-1));            /* Vertical   GRAM End   Address      */
-
-    /* Set Gate Scan Line ----------------------------------------------------*/
-    switch (driverCode) {
-      case 0x5408:                      /* LCD with SPFD5408 LCD Controller   */
-      case 0x9325:                      /* LCD with RM68050 LCD Controller    */
-       #if (LANDSCAPE ^ ROTATE180)
-        wr_reg(0x60, 0x2700);
-       #else
-        wr_reg(0x60, 0xA700);
-       #endif
-        break;
-
-      case 0x9320:                      /* LCD with ILI9320 LCD Controller    */
-      default:                          /* LCD with other LCD Controller      */
-       #if (LANDSCAPE ^ ROTATE180)
-        wr_reg(0x60, 0xA700);
-       #else
-        wr_reg(0x60, 0x2700);
-       #endif
-        break;
-    }
-    wr_reg(0x61, 0x0001);               /* NDL,VLE, REV                       */
-    wr_reg(0x6A, 0x0000);               /* Set scrolling line                 */
-
-    /* Partial Display Control -----------------------------------------------*/
-    wr_reg(0x80, 0x0000);
-    wr_reg(0x81, 0x0000);
-    wr_reg(0x82, 0x0000);
-    wr_reg(0x83, 0x0000);
-    wr_reg(0x84, 0x0000);
-    wr_reg(0x85, 0x0000);
-
-    /* Panel Control ---------------------------------------------------------*/
-    wr_reg(0x90, 0x0010);
-    wr_reg(0x92, 0x0000);
-    wr_reg(0x93, 0x0003);
-    wr_reg(0x95, 0x0110);
-    wr_reg(0x97, 0x0000);
-    wr_reg(0x98, 0x0000);
-
-    /* Set GRAM write direction
-       I/D=11 (Horizontal : increment, Vertical : increment)                  */
-  #if (LANDSCAPE == 1)
-    /* AM=1   (address is updated in vertical writing direction)              */
-    wr_reg(0x03, 0x1038);
-  #else
-    /* AM=0   (address is updated in horizontal writing direction)            */
-    wr_reg(0x03, 0x1030);
-  #endif
-
-    wr_reg(0x07, 0x0137);               /* 262K color and display ON          */
-  }
-  LPC_GPIO4->FIOSET = 0x10000000;
-}
-
-
-/*******************************************************************************
-* Set draw window region                                                       *
-*   Parameter:      x:        horizontal position                              *
-*                   y:        vertical position                                *
-*                   w:        window width in pixel                            *
-*                   h:        window height in pixels                          *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_SetWindow (unsigned int x, unsigned int y, unsigned int w, unsigned int h) {
-  unsigned int xe, ye;
-
-  if (Himax) {
-    xe = x+w-1;
-    ye = y+h-1;
-
-    wr_reg(0x02, x  >>    8);           /* Column address start MSB           */
-    wr_reg(0x03, x  &  0xFF);           /* Column address start LSB           */
-    wr_reg(0x04, xe >>    8);           /* Column address end MSB             */
-    wr_reg(0x05, xe &  0xFF);           /* Column address end LSB             */
-  
-    wr_reg(0x06, y  >>    8);           /* Row address start MSB              */
-    wr_reg(0x07, y  &  0xFF);           /* Row address start LSB              */
-    wr_reg(0x08, ye >>    8);           /* Row address end MSB                */
-    wr_reg(0x09, ye &  0xFF);           /* Row address end LSB                */
-  }
-  else {
-   #if (LANDSCAPE == 1)
-    wr_reg(0x50, y);                    /* Vertical   GRAM Start Address      */
-    wr_reg(0x51, y+h-1);                /* Vertical   GRAM End   Address (-1) */
-    wr_reg(0x52, x);                    /* Horizontal GRAM Start Address      */
-    wr_reg(0x53, x+w-1);                /* Horizontal GRAM End   Address (-1) */
-    wr_reg(0x20, y);
-    wr_reg(0x21, x);
-   #else
-    wr_reg(0x50, x);                    /* Horizontal GRAM Start Address      */
-    wr_reg(0x51, x+w-1);                /* Horizontal GRAM End   Address (-1) */
-    wr_reg(0x52, y);                    /* Vertical   GRAM Start Address      */
-    wr_reg(0x53, y+h-1);                /* Vertical   GRAM End   Address (-1) */
-    wr_reg(0x20, x);
-    wr_reg(0x21, y);
-   #endif
-  }
-}
-
-
-/*******************************************************************************
-* Set draw window region to whole screen                                       *
-*   Parameter:                                                                 *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_WindowMax (void) {
-  GLCD_SetWindow (0, 0, WIDTH, HEIGHT);
-}
-
-
-/*******************************************************************************
-* Draw a pixel in foreground color                                             *
-*   Parameter:      x:        horizontal position                              *
-*                   y:        vertical position                                *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_PutPixel (unsigned int x, unsigned int y) {
-
-  if (Himax) {
-    wr_reg(0x02, x >>    8);            /* Column address start MSB           */
-    wr_reg(0x03, x &  0xFF);            /* Column address start LSB           */
-    wr_reg(0x04, x >>    8);            /* Column address end MSB             */
-    wr_reg(0x05, x &  0xFF);            /* Column address end LSB             */
-  
-    wr_reg(0x06, y >>    8);            /* Row address start MSB              */
-    wr_reg(0x07, y &  0xFF);            /* Row address start LSB              */
-    wr_reg(0x08, y >>    8);            /* Row address end MSB                */
-    wr_reg(0x09, y &  0xFF);            /* Row address end LSB                */
-  }
-  else {
-   #if (LANDSCAPE == 1)
-    wr_reg(0x20, y);
-    wr_reg(0x21, x);
-   #else
-    wr_reg(0x20, x);
-    wr_reg(0x21, y);
-   #endif
-  }
-
-  wr_cmd(0x22);
-  wr_dat(Color[TXT_COLOR]);
-}
-
-
-/*******************************************************************************
-* Set foreground color                                                         *
-*   Parameter:      color:    foreground color                                 *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_SetTextColor (unsigned short color) {
-
-  Color[TXT_COLOR] = color;
-}
-
-
-/*******************************************************************************
-* Set background color                                                         *
-*   Parameter:      color:    background color                                 *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_SetBackColor (unsigned short color) {
-
-  Color[BG_COLOR] = color;
-}
-
-
-/*******************************************************************************
-* Clear display                                                                *
-*   Parameter:      color:    display clearing color                           *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_Clear (unsigned short color) {
-  unsigned int i;
-
-  GLCD_WindowMax();
-  wr_cmd(0x22);
-  wr_dat_start();
-
-  for(i = 0; i < (WIDTH*HEIGHT); i++)
-    wr_dat_only(color);
-  wr_dat_stop();
-}
-
-
-/*******************************************************************************
-* Draw character on given position                                             *
-*   Parameter:      x:        horizontal position                              *
-*                   y:        vertical position                                *
-*                   cw:       character width in pixel                         *
-*                   ch:       character height in pixels                       *
-*                   c:        pointer to character bitmap                      *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_DrawChar (unsigned int x, unsigned int y, unsigned int cw, unsigned int ch, unsigned char *c) {
-  unsigned int i, j, k, pixs;
-
-  GLCD_SetWindow(x, y, cw, ch);
-
-  wr_cmd(0x22);
-  wr_dat_start();
-
-  k  = (cw + 7)/8;
-
-  if (k == 1) {
-    for (j = 0; j < ch; j++) {
-      pixs = *(unsigned char  *)c;
-      c += 1;
-      
-      for (i = 0; i < cw; i++) {
-        wr_dat_only (Color[(pixs >> i) & 1]);
-      }
-    }
-  }
-  else if (k == 2) {
-    for (j = 0; j < ch; j++) {
-      pixs = *(unsigned short *)c;
-      c += 2;
-      
-      for (i = 0; i < cw; i++) {
-        wr_dat_only (Color[(pixs >> i) & 1]);
-      }
-    }
-  }
-  wr_dat_stop();
-}
-
-
-/*******************************************************************************
-* Disply character on given line                                               *
-*   Parameter:      ln:       line number                                      *
-*                   col:      column number                                    *
-*                   fi:       font index (0 = 6x8, 1 = 16x24)                  *
-*                   c:        ascii character                                  *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_DisplayChar (unsigned int ln, unsigned int col, unsigned char fi, unsigned char c) {
-
-  c -= 32;
-  switch (fi) {
-    case 0:  /* Font 6 x 8 */
-      GLCD_DrawChar(col *  6, ln *  8,  6,  8, (unsigned char *)&Font_6x8_h  [c * 8]);
-      break;
-    case 1:  /* Font 16 x 24 */
-      GLCD_DrawChar(col * 16, ln * 24, 16, 24, (unsigned char *)&Font_16x24_h[c * 24]);
-      break;
-  }
-}
-
-
-/*******************************************************************************
-* Disply string on given line                                                  *
-*   Parameter:      ln:       line number                                      *
-*                   col:      column number                                    *
-*                   fi:       font index (0 = 6x8, 1 = 16x24)                  *
-*                   s:        pointer to string                                *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_DisplayString (unsigned int ln, unsigned int col, unsigned char fi, unsigned char *s) {
-
-  while (*s) {
-    GLCD_DisplayChar(ln, col++, fi, *s++);
-  }
-}
-
-
-/*******************************************************************************
-* Clear given line                                                             *
-*   Parameter:      ln:       line number                                      *
-*                   fi:       font index (0 = 6x8, 1 = 16x24)                  *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_ClearLn (unsigned int ln, unsigned char fi) {
-  unsigned char i;
-  unsigned char buf[60];
-
-  GLCD_WindowMax();
-  switch (fi) {
-    case 0:  /* Font 6 x 8 */
-      for (i = 0; i < (WIDTH+5)/6; i++)
-        buf[i] = ' ';
-      buf[i+1] = 0;
-      break;
-    case 1:  /* Font 16 x 24 */
-      for (i = 0; i < (WIDTH+15)/16; i++)
-        buf[i] = ' ';
-      buf[i+1] = 0;
-      break;
-  }
-  GLCD_DisplayString (ln, 0, fi, buf);
-}
-
-/*******************************************************************************
-* Draw bargraph                                                                *
-*   Parameter:      x:        horizontal position                              *
-*                   y:        vertical position                                *
-*                   w:        maximum width of bargraph (in pixels)            *
-*                   h:        bargraph height                                  *
-*                   val:      value of active bargraph (in 1/1024)             *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_Bargraph (unsigned int x, unsigned int y, unsigned int w, unsigned int h, unsigned int val) {
-  int i,j;
-
-  val = (val * w) >> 10;                /* Scale value                        */
-  GLCD_SetWindow(x, y, w, h);
-  wr_cmd(0x22);
-  wr_dat_start();
-  for (i = 0; i < h; i++) {
-    for (j = 0; j <= w-1; j++) {
-      if(j >= val) {
-        wr_dat_only(Color[BG_COLOR]);
-      } else {
-        wr_dat_only(Color[TXT_COLOR]);
-      }
-    }
-  }
-  wr_dat_stop();
-}
-
-
-/*******************************************************************************
-* Display graphical bitmap image at position x horizontally and y vertically   *
-* (This function is optimized for 16 bits per pixel format, it has to be       *
-*  adapted for any other bits per pixel format)                                *
-*   Parameter:      x:        horizontal position                              *
-*                   y:        vertical position                                *
-*                   w:        width of bitmap                                  *
-*                   h:        height of bitmap                                 *
-*                   bitmap:   address at which the bitmap data resides         *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_Bitmap (unsigned int x, unsigned int y, unsigned int w, unsigned int h, unsigned char *bitmap) {
-  int i, j;
-  unsigned short *bitmap_ptr = (unsigned short *)bitmap;
-
-  GLCD_SetWindow (x, y, w, h);
-
-  wr_cmd(0x22);
-  wr_dat_start();
-  for (i = (h-1)*w; i > -1; i -= w) {
-    for (j = 0; j < w; j++) {
-      wr_dat_only (bitmap_ptr[i+j]);
-    }
-  }
-  wr_dat_stop();
-}
-
-
-
-/*******************************************************************************
-* Scroll content of the whole display for dy pixels vertically                 *
-*   Parameter:      dy:       number of pixels for vertical scroll             *
-*   Return:                                                                    *
-*******************************************************************************/
-
-void GLCD_ScrollVertical (unsigned int dy) {
-#if (LANDSCAPE == 0)
-  static unsigned int y = 0;
-
-  y = y + dy;
-  while (y >= HEIGHT)
-    y -= HEIGHT;
-
-  if (Himax) {
-    wr_reg(0x01, 0x08);
-    wr_reg(0x14, y>>8);                 /* VSP MSB                            */
-    wr_reg(0x15, y&0xFF);               /* VSP LSB                            */
-  }
-  else {
-    wr_reg(0x6A, y);
-    wr_reg(0x61, 3);
-  }
-#endif
-}
-
-
-/*******************************************************************************
-* Write a command to the LCD controller                                        *
-*   Parameter:      cmd:      command to write to the LCD                      *
-*   Return:                                                                    *
-*******************************************************************************/
-void GLCD_WrCmd (unsigned char cmd) {
-  wr_cmd (cmd);
-}
-
-
-/*******************************************************************************
-* Write a value into LCD controller register                                   *
-*   Parameter:      reg:      lcd register address                             *
-*                   val:      value to write into reg                          *
-*   Return:                                                                    *
-*******************************************************************************/
-void GLCD_WrReg (unsigned char reg, unsigned short val) {
-  wr_reg (reg, val);
-}
-/******************************************************************************/
+/******************************************************************************/
+/* GLCD_SPI_LPC1700.c: LPC1700 low level Graphic LCD (240x320 pixels) driven  */
+/*                     with SPI functions                                     */
+/******************************************************************************/
+/* This file is part of the uVision/ARM development tools.                    */
+/* Copyright (c) 2005-2011 Keil - An ARM Company. All rights reserved.        */
+/* This software may only be used under the terms of a valid, current,        */
+/* end user licence from KEIL for a compatible version of KEIL software       */
+/* development tools. Nothing else gives you the right to use this software.  */
+/******************************************************************************/
+
+
+#include <lpc17xx.h>
+#include "GLCD.h"
+#include "Font_6x8_h.h"
+#include "Font_16x24_h.h"
+
+/************************** Orientation  configuration ************************/
+
+#define LANDSCAPE   0                   /* 1 for landscape, 0 for portrait    */
+#define ROTATE180   0                   /* 1 to rotate the screen for 180 deg */
+
+/************************** Transfer configuration ****************************/
+
+#define USE_DMA     1                   /* 1 to stream pixel bursts with DMA  */
+#define DMA_MIN_PX  32                  /* Shorter bursts are sent by the CPU */
+
+/*********************** Hardware specific configuration **********************/
+
+/* SPI Interface: SPI3
+   
+   PINS: 
+   - CS     = P0.6 (GPIO pin)
+   - RS     = GND
+   - WR/SCK = P0.7 (SCK1)
+   - RD     = GND
+   - SDO    = P0.8 (MISO1)
+   - SDI    = P0.9 (MOSI1)                                                    */
+
+#define PIN_CS      (1 << 6)
+#define PIN_CLK     (1 << 7)
+#define PIN_DAT     (1 << 9)
+
+#define IN          0x00
+#define OUT         0x01
+
+/* SPI_SR - bit definitions                                                   */
+#define TFE         0x01
+#define TNF         0x02
+#define RNE         0x04
+#define BSY         0x10
+
+/* SSP_CR0 - data size select                                                 */
+#define DSS_MASK    0x0F
+#define DSS_8       0x07                /* 8-bit frames (commands, start byte)*/
+#define DSS_16      0x0F                /* 16-bit frames (one RGB565 pixel)   */
+
+/* SSP_ICR / SSP_DMACR - bit definitions                                      */
+#define RORIC       0x01
+#define RTIC        0x02
+#define TXDMAE      0x02
+
+/* Shadowed window and cursor registers: 0x02..0x09 (Himax window),          */
+/* 0x20/0x21 (GRAM address), 0x50..0x53 (window)                              */
+#define SHADOW_NUM  14
+#define SHADOW_AC   0x0333              /* Start and cursor shadows (02,03,   */
+                                        /* 06,07,20,21) spoilt by GRAM access */
+
+/* GPDMA channel used for SSP1 transmit                                       */
+#define DMA_CH      LPC_GPDMACH0
+#define DMA_CH_MSK  0x01
+#define DMA_SSP1_TX 2                   /* SSP1 Tx peripheral connection      */
+#define DMA_MAX     4095                /* Max. transfers per channel setup   */
+
+/*------------------------- Speed dependant settings -------------------------*/
+
+/* If processor works on high frequency delay has to be increased, it can be 
+   increased by factor 2^N by this constant                                   */
+#define DELAY_2N    18
+
+/*---------------------- Graphic LCD size definitions ------------------------*/
+
+#if (LANDSCAPE == 1)
+#define WIDTH       320                 /* Screen Width (in pixels)           */
+#define HEIGHT      240                 /* Screen Hight (in pixels)           */
+#else
+#define WIDTH       240                 /* Screen Width (in pixels)           */
+#define HEIGHT      320                 /* Screen Hight (in pixels)           */
+#endif
+#define BPP         16                  /* Bits per pixel                     */
+#define BYPP        ((BPP+7)/8)         /* Bytes per pixel                    */
+
+/*--------------- Graphic LCD interface hardware definitions -----------------*/
+
+/* Pin CS setting to 0 or 1                                                   */
+#define LCD_CS(x)   ((x) ? (LPC_GPIO0->FIOSET = PIN_CS)    : (LPC_GPIO0->FIOCLR = PIN_CS))
+#define LCD_CLK(x)  ((x) ? (LPC_GPIO0->FIOSET = PIN_CLK)   : (LPC_GPIO0->FIOCLR = PIN_CLK))
+#define LCD_DAT(x)  ((x) ? (LPC_GPIO0->FIOSET = PIN_DAT)   : (LPC_GPIO0->FIOCLR = PIN_DAT))
+
+#define DAT_MODE(x) ((x == OUT) ? (LPC_GPIO0->FIODIR |= PIN_DAT) : (LPC_GPIO0->FIODIR &= ~PIN_DAT))
+#define BUS_VAL()                ((LPC_GPIO0->FIOPIN  & PIN_DAT) != 0)
+
+
+#define SPI_START   (0x70)              /* Start byte for SPI transfer        */
+#define SPI_RD      (0x01)              /* WR bit 1 within start              */
+#define SPI_WR      (0x00)              /* WR bit 0 within start              */
+#define SPI_DATA    (0x02)              /* RS bit 1 within start byte         */
+#define SPI_INDEX   (0x00)              /* RS bit 0 within start byte         */
+
+#define BG_COLOR  0                     /* Background color                   */
+#define TXT_COLOR 1                     /* Text color                         */
+
+ 
+/*---------------------------- Global variables ------------------------------*/
+
+/******************************************************************************/
+static volatile unsigned short Color[2] = {White, Black};
+static unsigned char Himax;
+
+static unsigned short reg_shadow[SHADOW_NUM];   /* Last value written         */
+static unsigned short reg_valid;                /* Bit n: reg_shadow[n] valid */
+static unsigned int   reg_issued;               /* Shadowed writes sent       */
+static unsigned int   reg_elided;               /* Shadowed writes skipped    */
+
+#if (USE_DMA == 1)
+static volatile unsigned short  dma_fill;       /* Source of solid fills      */
+static const unsigned short    *dma_row;        /* First pixel of current row */
+static const unsigned short    *dma_src;        /* Next pixel to be sent      */
+static volatile unsigned int    dma_left;       /* Pixels left in current row */
+static volatile unsigned int    dma_rows;       /* Rows left after current one*/
+static unsigned int             dma_w;          /* Pixels per row             */
+static int                      dma_stride;     /* Pixel step between rows    */
+static unsigned char            dma_inc;        /* Source increment (0: fill) */
+static volatile unsigned char   dma_busy;       /* Burst in progress flag     */
+static void                   (*dma_done)(void);/* Called from DMA interrupt  */
+static void                   (*dma_idle)(void);/* Called while waiting       */
+#endif
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Delay in while loop cycles                                                   *
+*   Parameter:    cnt:    number of while cycles to delay                      *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static void delay (int cnt) {
+  cnt <<= DELAY_2N;
+  while (cnt--);
+}
+
+
+/*******************************************************************************
+* Set the SSP frame size                                                       *
+*   Parameter:    dss:    DSS_8 or DSS_16                                      *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void ssp_frame (unsigned int dss) {
+
+  LPC_SSP1->CR0 = (LPC_SSP1->CR0 & ~DSS_MASK) | dss;
+}
+
+
+/*******************************************************************************
+* Wait for the transmitter to go idle and discard everything received          *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void ssp_flush (void) {
+
+  while (LPC_SSP1->SR & BSY);           /* Wait for last frame to shift out   */
+  while (LPC_SSP1->SR & RNE) {          /* Drain receive FIFO                 */
+    (void)LPC_SSP1->DR;
+  }
+  LPC_SSP1->ICR = RORIC | RTIC;         /* Clear receive overrun              */
+}
+
+
+#if (USE_DMA == 1)
+/*******************************************************************************
+* Program the DMA channel with the next part of the current row                *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static void dma_next (void) {
+  unsigned int n = dma_left;
+
+  if (n > DMA_MAX) n = DMA_MAX;
+  dma_left -= n;
+
+  LPC_GPDMA->DMACIntTCClear = DMA_CH_MSK;
+  LPC_GPDMA->DMACIntErrClr  = DMA_CH_MSK;
+  DMA_CH->DMACCSrcAddr  = (uintptr_t)dma_src;
+  DMA_CH->DMACCDestAddr = (uintptr_t)&LPC_SSP1->DR;
+  DMA_CH->DMACCLLI      = 0;
+  DMA_CH->DMACCControl  = n          |  /* Transfer size                      */
+                          (1 << 12)  |  /* Source burst size: 4               */
+                          (1 << 15)  |  /* Destination burst size: 4          */
+                          (1 << 18)  |  /* Source width: 16 bit               */
+                          (1 << 21)  |  /* Destination width: 16 bit          */
+                          (dma_inc << 26) | /* Source increment               */
+                          (1UL << 31);  /* Terminal count interrupt           */
+  DMA_CH->DMACCConfig   = 1          |  /* Channel enable                     */
+                          (DMA_SSP1_TX << 6) | /* Destination peripheral      */
+                          (1 << 11)  |  /* Memory to peripheral               */
+                          (1 << 14)  |  /* Error interrupt mask               */
+                          (1 << 15);    /* Terminal count interrupt mask      */
+
+  if (dma_inc) dma_src += n;
+}
+
+
+/*******************************************************************************
+* Start a pixel burst streamed by DMA (wr_px_start must already be called)     *
+*   Parameter:    src:    first pixel of the first row                         *
+*                 w:      pixels per row                                       *
+*                 h:      number of rows                                       *
+*                 stride: pixel step from one row to the next                  *
+*                 inc:    1 = read successive pixels, 0 = repeat *src          *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static void dma_start (const unsigned short *src, unsigned int w, unsigned int h,
+                       int stride, unsigned char inc) {
+
+  dma_busy   = 1;
+  dma_row    = src;
+  dma_src    = src;
+  dma_w      = w;
+  dma_left   = w;
+  dma_rows   = h - 1;
+  dma_stride = stride;
+  dma_inc    = inc;
+  LPC_SSP1->DMACR = TXDMAE;
+  dma_next();
+}
+
+
+/*******************************************************************************
+* Wait until the running DMA burst has finished                                *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void dma_wait (void) {
+
+  while (dma_busy) {
+    if (dma_idle) dma_idle();
+  }
+}
+#endif
+
+
+/*******************************************************************************
+* Transfer 1 byte over the serial communication                                *
+*   Parameter:    byte:   byte to be sent                                      *
+*                 mode:   OUT = transmit byte, IN = receive byte               *
+*   Return:               byte read while sending                              *
+*******************************************************************************/
+static unsigned char spi_tran_man (unsigned char byte, unsigned int mode) {
+  unsigned char val = 0;
+  int i;
+
+  if (mode == OUT) { DAT_MODE (OUT); }
+  else             { DAT_MODE (IN);  }
+
+  for (i = 7; i >= 0; i--) {
+    LCD_CLK(0);
+    delay(1);
+    if (mode == OUT) {
+      LCD_DAT((byte & (1 << i)) != 0);
+    }
+    else {
+      val |= (BUS_VAL() << i);
+    }
+    LCD_CLK(1);
+    delay(1);
+  }
+  return (val);
+}
+
+
+/*******************************************************************************
+* Transfer 1 byte over the serial communication                                *
+*   Parameter:    byte:   byte to be sent                                      *
+*   Return:               byte read while sending                              *
+*******************************************************************************/
+
+static __inline unsigned char spi_tran (unsigned char byte) {
+
+  LPC_SSP1->DR = byte;
+  while (!(LPC_SSP1->SR & RNE));        /* Wait for send to finish            */
+  return (LPC_SSP1->DR);
+}
+
+
+/*******************************************************************************
+* Write a command the LCD controller                                           *
+*   Parameter:    cmd:    command to be written                                *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void wr_cmd (unsigned char cmd) {
+#if (USE_DMA == 1)
+  dma_wait();                           /* Bus is owned by a running burst    */
+#endif
+  if (cmd == 0x22) {                    /* GRAM access moves address counter  */
+    reg_valid &= ~SHADOW_AC;
+  }
+  LCD_CS(0);
+  spi_tran(SPI_START | SPI_WR | SPI_INDEX);   /* Write : RS = 0, RW = 0       */
+  spi_tran(0);
+  spi_tran(cmd);
+  LCD_CS(1);
+}
+
+
+/*******************************************************************************
+* Write data to the LCD controller                                             *
+*   Parameter:    dat:    data to be written                                   *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void wr_dat (unsigned short dat) {
+  LCD_CS(0);
+  spi_tran(SPI_START | SPI_WR | SPI_DATA);    /* Write : RS = 1, RW = 0       */
+  spi_tran((dat >>   8));                     /* Write D8..D15                */
+  spi_tran((dat & 0xFF));                     /* Write D0..D7                 */
+  LCD_CS(1);
+}
+
+
+/*******************************************************************************
+* Start of data writing to the LCD controller                                  *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void wr_dat_start (void) {
+  LCD_CS(0);
+  spi_tran(SPI_START | SPI_WR | SPI_DATA);    /* Write : RS = 1, RW = 0       */
+}
+
+
+/*******************************************************************************
+* Stop of data writing to the LCD controller                                   *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void wr_dat_stop (void) {
+
+  LCD_CS(1);
+}
+
+
+/*******************************************************************************
+* Data writing to the LCD controller                                           *
+*   Parameter:    dat:    data to be written                                   *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void wr_dat_only (unsigned short dat) {
+
+  spi_tran((dat >>   8));                     /* Write D8..D15                */
+  spi_tran((dat & 0xFF));                     /* Write D0..D7                 */
+}
+
+
+/*******************************************************************************
+* Start of pixel burst: data phase with 16-bit frames, receive is ignored      *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void wr_px_start (void) {
+
+  wr_dat_start();
+  ssp_frame(DSS_16);                    /* One frame per RGB565 pixel         */
+}
+
+
+/*******************************************************************************
+* Pixel writing to the LCD controller, only waits while the TX FIFO is full    *
+*   Parameter:    px:     pixel to be written                                  *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void wr_px (unsigned short px) {
+
+  while (!(LPC_SSP1->SR & TNF));        /* Wait for room in TX FIFO           */
+  LPC_SSP1->DR = px;
+}
+
+
+/*******************************************************************************
+* Stop of pixel burst: drain the SSP and go back to 8-bit frames               *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+static __inline void wr_px_stop (void) {
+
+  ssp_flush();
+  ssp_frame(DSS_8);
+  wr_dat_stop();
+}
+
+
+/*******************************************************************************
+* Read data from the LCD controller                                            *
+*   Parameter:                                                                 *
+*   Return:               read data                                            *
+*******************************************************************************/
+
+static __inline unsigned short rd_dat (void) {
+  unsigned short val = 0;
+
+  LCD_CS(0);
+  spi_tran(SPI_START | SPI_RD | SPI_DATA);    /* Read: RS = 1, RW = 1         */
+  spi_tran(0);                                /* Dummy read 1                 */  
+  val   = spi_tran(0);                        /* Read D8..D15                 */
+  val <<= 8;
+  val  |= spi_tran(0);                        /* Read D0..D7                  */
+  LCD_CS(1);
+  return (val);
+}
+
+
+/*******************************************************************************
+* Write a value to the to LCD register                                         *
+*   Parameter:    reg:    register to be written                               *
+*                 val:    value to write to the register                       *
+*******************************************************************************/
+
+static __inline void wr_reg (unsigned char reg, unsigned short val) {
+
+  wr_cmd(reg);
+  wr_dat(val);
+}
+
+
+/*******************************************************************************
+* Get the shadow index of a register                                           *
+*   Parameter:    reg:    register                                             *
+*   Return:               index into reg_shadow, -1 if not shadowed            *
+*******************************************************************************/
+
+static __inline int reg_index (unsigned char reg) {
+
+  if (reg >= 0x02 && reg <= 0x09) return (reg - 0x02);
+  if (reg == 0x20 || reg == 0x21) return (reg - 0x20 + 8);
+  if (reg >= 0x50 && reg <= 0x53) return (reg - 0x50 + 10);
+  return (-1);
+}
+
+
+/*******************************************************************************
+* Write a value to a shadowed LCD register, skipped if it would not change     *
+* the controller state                                                         *
+*   Parameter:    reg:    register to be written                               *
+*                 val:    value to write to the register                       *
+*******************************************************************************/
+
+static __inline void wr_reg_cached (unsigned char reg, unsigned short val) {
+  int idx = reg_index(reg);
+
+  if ((reg_valid & (1 << idx)) && reg_shadow[idx] == val) {
+    reg_elided++;
+    return;
+  }
+  wr_reg(reg, val);
+  reg_shadow[idx] = val;
+  reg_valid |= (1 << idx);
+  reg_issued++;
+}
+
+
+/*******************************************************************************
+* Read from the LCD register                                                   *
+*   Parameter:    reg:    register to be read                                  *
+*   Return:               value read from the register                         *
+*******************************************************************************/
+
+static unsigned short rd_reg (unsigned char reg) {
+
+  wr_cmd(reg);
+  return(rd_dat());
+}
+
+
+/*******************************************************************************
+* Read LCD controller ID (Himax GLCD)                                          *
+*   Parameter:    (none)                                                       *
+*   Return:       controller ID                                                *
+*******************************************************************************/
+
+static unsigned short rd_id_man (void) {
+  unsigned short val;
+
+  /* Set MOSI, MISO and SCK as GPIO pins, with pull-down/pull-up disabled     */
+  LPC_PINCON->PINSEL0  &= ~((3 << 18) | (3 << 16) | (3 << 14));
+  LPC_PINCON->PINMODE0 |= 0x000AA000;
+  LPC_GPIO0->FIODIR    |= PIN_CLK;      /* SCK pin is GPIO output             */
+  LCD_CS (1);                           /* Set chip select high               */
+  LCD_CLK(1);                           /* Set clock high                     */
+
+  LCD_CS(0);
+  spi_tran_man (SPI_START | SPI_WR | SPI_INDEX, OUT);
+  spi_tran_man (0x00, OUT);
+  LCD_CS(1);
+
+  LCD_CS(0);
+  spi_tran_man (SPI_START | SPI_RD | SPI_DATA, OUT);
+  val = spi_tran_man(0, IN);
+  LCD_CS(1);
+
+  /* Connect MOSI, MISO, and SCK to SSP peripheral                            */
+  LPC_GPIO0->FIODIR    &= ~PIN_CLK;
+  LPC_PINCON->PINSEL0  |= (2 << 18) | (2 << 16) | (2 << 14);
+  LPC_PINCON->PINMODE0 &= ~0x000FF000;
+
+  return (val);
+}
+
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Initialize the Graphic LCD controller                                        *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_Init (void) {
+  unsigned short driverCode;
+
+  /* Enable clock for SSP1, clock = CCLK / 2                                  */
+  LPC_SC->PCONP       |= 0x00000400;
+  LPC_SC->PCLKSEL0    |= 0x00200000;
+
+  /* Configure the LCD Control pins                                           */
+  LPC_PINCON->PINSEL9 &= 0xF0FFFFFF;
+  LPC_GPIO4->FIODIR   |= 0x30000000;
+  LPC_GPIO4->FIOSET    = 0x20000000;
+
+  /* SSEL1 is GPIO output set to high                                         */
+  LPC_GPIO0->FIODIR   |= 0x00000040;
+  LPC_GPIO0->FIOSET    = 0x00000040;
+  LPC_PINCON->PINSEL0 &= 0xFFF03FFF;
+  LPC_PINCON->PINSEL0 |= 0x000A8000;
+
+#if (USE_DMA == 1)
+  /* Enable GPDMA controller, channel is set up per burst                     */
+  LPC_SC->PCONP       |= 0x20000000;
+  LPC_GPDMA->DMACConfig = 0x01;
+  NVIC_EnableIRQ(DMA_IRQn);
+#endif
+
+  /* Enable SPI in Master Mode, CPOL=1, CPHA=1                                */
+  /* Max. 12.5 MBit used for Data Transfer @ 100MHz                           */
+  LPC_SSP1->CR0        = 0x01C7;
+  LPC_SSP1->CPSR       = 0x02;
+  LPC_SSP1->CR1        = 0x02;
+  
+  driverCode = rd_id_man ();
+  if (driverCode == 0) {
+    driverCode = rd_reg(0x00);
+  }
+
+  if (driverCode == 0x47) {             /* LCD with HX8347-D LCD Controller   */
+    Himax = 1;                          /* Set Himax LCD controller flag      */
+    /* Driving ability settings ----------------------------------------------*/
+    wr_reg(0xEA, 0x00);                 /* Power control internal used (1)    */
+    wr_reg(0xEB, 0x20);                 /* Power control internal used (2)    */
+    wr_reg(0xEC, 0x0C);                 /* Source control internal used (1)   */
+    wr_reg(0xED, 0xC7);                 /* Source control internal used (2)   */
+    wr_reg(0xE8, 0x38);                 /* Source output period Normal mode   */
+    wr_reg(0xE9, 0x10);                 /* Source output period Idle mode     */
+    wr_reg(0xF1, 0x01);                 /* RGB 18-bit interface ;0x0110       */
+    wr_reg(0xF2, 0x10);
+
+    /* Adjust the Gamma Curve ------------------------------------------------*/
+    wr_reg(0x40, 0x01);
+    wr_reg(0x41, 0x00);
+    wr_reg(0x42, 0x00);
+    wr_reg(0x43, 0x10);
+    wr_reg(0x44, 0x0E);
+    wr_reg(0x45, 0x24);
+    wr_reg(0x46, 0x04);
+    wr_reg(0x47, 0x50);
+    wr_reg(0x48, 0x02);
+    wr_reg(0x49, 0x13);
+    wr_reg(0x4A, 0x19);
+    wr_reg(0x4B, 0x19);
+    wr_reg(0x4C, 0x16);
+
+    wr_reg(0x50, 0x1B);
+    wr_reg(0x51, 0x31);
+    wr_reg(0x52, 0x2F);
+    wr_reg(0x53, 0x3F);
+    wr_reg(0x54, 0x3F);
+    wr_reg(0x55, 0x3E);
+    wr_reg(0x56, 0x2F);
+    wr_reg(0x57, 0x7B);
+    wr_reg(0x58, 0x09);
+    wr_reg(0x59, 0x06);
+    wr_reg(0x5A, 0x06);
+    wr_reg(0x5B, 0x0C);
+    wr_reg(0x5C, 0x1D);
+    wr_reg(0x5D, 0xCC);
+
+    /* Power voltage setting -------------------------------------------------*/
+    wr_reg(0x1B, 0x1B);
+    wr_reg(0x1A, 0x01);
+    wr_reg(0x24, 0x2F);
+    wr_reg(0x25, 0x57);
+    wr_reg(0x23, 0x88);
+
+    /* Power on setting ------------------------------------------------------*/
+    wr_reg(0x18, 0x36);                 /* Internal oscillator frequency adj  */
+    wr_reg(0x19, 0x01);                 /* Enable internal oscillator         */
+    wr_reg(0x01, 0x00);                 /* Normal mode, no scrool             */
+    wr_reg(0x1F, 0x88);                 /* Power control 6 - DDVDH Off        */
+    delay(20);
+    wr_reg(0x1F, 0x82);                 /* Power control 6 - Step-up: 3 x VCI */
+    delay(5);
+    wr_reg(0x1F, 0x92);                 /* Power control 6 - Step-up: On      */
+    delay(5);
+    wr_reg(0x1F, 0xD2);                 /* Power control 6 - VCOML active     */
+    delay(5);
+
+    /* Color selection -------------------------------------------------------*/
+    wr_reg(0x17, 0x55);                 /* RGB, System interface: 16 Bit/Pixel*/
+    wr_reg(0x00, 0x00);                 /* Scrolling off, no standby          */
+
+    /* Interface config ------------------------------------------------------*/
+    wr_reg(0x2F, 0x11);                 /* LCD Drive: 1-line inversion        */
+    wr_reg(0x31, 0x00);
+    wr_reg(0x32, 0x00);                 /* DPL=0, HSPL=0, VSPL=0, EPL=0       */
+
+    /* Display on setting ----------------------------------------------------*/
+    wr_reg(0x28, 0x38);                 /* PT(0,0) active, VGL/VGL            */
+    delay(20);
+    wr_reg(0x28, 0x3C);                 /* Display active, VGL/VGL            */
+
+   #if (LANDSCAPE == 1)
+    #if (ROTATE180 == 0)
+     wr_reg (0x16, 0xA8);
+    #else
+     wr_reg (0x16, 0x68);
+    #endif
+   #else
+    #if (ROTATE180 == 0)
+     wr_reg (0x16, 0x08);
+    #else
+     wr_reg (0x16, 0xC8);
+    #endif
+   #endif
+
+    /* Display scrolling settings --------------------------------------------*/
+    wr_reg(0x0E, 0x00);                 /* TFA MSB                            */
+    wr_reg(0x0F, 0x00);                 /* TFA LSB                            */
+    wr_reg(0x10, 320 >> 8);             /* VSA MSB                            */
+    wr_reg(0x11, 320 &  0xFF);          /* VSA LSB                            */
+    wr_reg(0x12, 0x00);                 /* BFA MSB                            */
+    wr_reg(0x13, 0x00);                 /* BFA LSB                            */
+  }
+  else {
+    Himax = 0;                          /* This is not Himax LCD controller   */
+    /* Start Initial Sequence ------------------------------------------------*/
+   #if (ROTATE180 == 1)
+    wr_reg(0x01, 0x0000);               /* Clear SS bit                       */
+   #else
+    wr_reg(0x01, 0x0100);               /* Set SS bit                         */
+   #endif
+    wr_reg(0x02, 0x0700);               /* Set 1 line inversion               */
+    wr_reg(0x04, 0x0000);               /* Resize register                    */
+    wr_reg(0x08, 0x0207);               /* 2 lines front, 7 back porch        */
+    wr_reg(0x09, 0x0000);               /* Set non-disp area refresh cyc ISC  */
+    wr_reg(0x0A, 0x0000);               /* FMARK function                     */
+    wr_reg(0x0C, 0x0000);               /* RGB interface setting              */
+    wr_reg(0x0D, 0x0000);               /* Frame marker Position              */
+    wr_reg(0x0F, 0x0000);               /* RGB interface polarity             */
+
+    /* Power On sequence -----------------------------------------------------*/
+    wr_reg(0x10, 0x0000);               /* Reset Power Control 1              */
+    wr_reg(0x11, 0x0000);               /* Reset Power Control 2              */
+    wr_reg(0x12, 0x0000);               /* Reset Power Control 3              */
+    wr_reg(0x13, 0x0000);               /* Reset Power Control 4              */
+    delay(20);                          /* Discharge cap power voltage (200ms)*/
+    wr_reg(0x10, 0x12B0);               /* SAP, BT[3:0], AP, DSTB, SLP, STB   */
+    wr_reg(0x11, 0x0007);               /* DC1[2:0], DC0[2:0], VC[2:0]        */
+    delay(5);                           /* Delay 50 ms                        */
+    wr_reg(0x12, 0x01BD);               /* VREG1OUT voltage                   */
+    delay(5);                           /* Delay 50 ms                        */
+    wr_reg(0x13, 0x1400);               /* VDV[4:0] for VCOM amplitude        */
+    wr_reg(0x29, 0x000E);               /* VCM[4:0] for VCOMH                 */
+    delay(5);                           /* Delay 50 ms                        */
+    wr_reg(0x20, 0x0000);               /* GRAM horizontal Address            */
+    wr_reg(0x21, 0x0000);               /* GRAM Vertical Address              */
+
+    /* Adjust the Gamma Curve ------------------------------------------------*/
+    switch (driverCode) {
+      case 0x5408:                      /* LCD with SPFD5408 LCD Controller   */
+        wr_reg(0x30, 0x0B0D);
+        wr_reg(0x31, 0x1923);
+        wr_reg(0x32, 0x1C26);
+        wr_reg(0x33, 0x261C);
+        wr_reg(0x34, 0x2419);
+        wr_reg(0x35, 0x0D0B);
+        wr_reg(0x36, 0x1006);
+        wr_reg(0x37, 0x0610);
+        wr_reg(0x38, 0x0706);
+        wr_reg(0x39, 0x0304);
+        wr_reg(0x3A, 0x0E05);
+        wr_reg(0x3B, 0x0E01);
+        wr_reg(0x3C, 0x010E);
+        wr_reg(0x3D, 0x050E);
+        wr_reg(0x3E, 0x0403);
+        wr_reg(0x3F, 0x0607);
+        break;
+
+      case 0x9325:                      /* LCD with RM68050 LCD Controller    */
+        wr_reg(0x0030,0x0000);
+        wr_reg(0x0031,0x0607);
+        wr_reg(0x0032,0x0305);
+        wr_reg(0x0035,0x0000);
+        wr_reg(0x0036,0x1604);
+        wr_reg(0x0037,0x0204);
+        wr_reg(0x0038,0x0001);
+        wr_reg(0x0039,0x0707);
+        wr_reg(0x003C,0x0000);
+        wr_reg(0x003D,0x000F);
+        break;
+
+      case 0x9320:                      /* LCD with ILI9320 LCD Controller    */
+      default:                          /* LCD with other LCD Controller      */
+        wr_reg(0x30, 0x0006);
+        wr_reg(0x31, 0x0101);
+        wr_reg(0x32, 0x0003);
+        wr_reg(0x35, 0x0106);
+        wr_reg(0x36, 0x0B02);
+        wr_reg(0x37, 0x0302);
+        wr_reg(0x38, 0x0707);
+        wr_reg(0x39, 0x0007);
+        wr_reg(0x3C, 0x0600);
+        wr_reg(0x3D, 0x020B);
+        break;
+    }
+
+    /* Set GRAM area ---------------------------------------------------------*/
+    wr_reg(0x50, 0x0000);               /* Horizontal GRAM Start Address      */
+    wr_reg(0x51, (HEIGHT-1));           /* Horizontal GRAM End   Address      */
+    wr_reg(0x52, 0x0000);               /* Vertical   GRAM Start Address      */
+    wr_reg(0x53, (WIDTH-1));            /* Vertical   GRAM End   Address      */
+
+    /* Set Gate Scan Line ----------------------------------------------------*/
+    switch (driverCode) {
+      case 0x5408:                      /* LCD with SPFD5408 LCD Controller   */
+      case 0x9325:                      /* LCD with RM68050 LCD Controller    */
+       #if (LANDSCAPE ^ ROTATE180)
+        wr_reg(0x60, 0x2700);
+       #else
+        wr_reg(0x60, 0xA700);
+       #endif
+        break;
+
+      case 0x9320:                      /* LCD with ILI9320 LCD Controller    */
+      default:                          /* LCD with other LCD Controller      */
+       #if (LANDSCAPE ^ ROTATE180)
+        wr_reg(0x60, 0xA700);
+       #else
+        wr_reg(0x60, 0x2700);
+       #endif
+        break;
+    }
+    wr_reg(0x61, 0x0001);               /* NDL,VLE, REV                       */
+    wr_reg(0x6A, 0x0000);               /* Set scrolling line                 */
+
+    /* Partial Display Control -----------------------------------------------*/
+    wr_reg(0x80, 0x0000);
+    wr_reg(0x81, 0x0000);
+    wr_reg(0x82, 0x0000);
+    wr_reg(0x83, 0x0000);
+    wr_reg(0x84, 0x0000);
+    wr_reg(0x85, 0x0000);
+
+    /* Panel Control ---------------------------------------------------------*/
+    wr_reg(0x90, 0x0010);
+    wr_reg(0x92, 0x0000);
+    wr_reg(0x93, 0x0003);
+    wr_reg(0x95, 0x0110);
+    wr_reg(0x97, 0x0000);
+    wr_reg(0x98, 0x0000);
+
+    /* Set GRAM write direction
+       I/D=11 (Horizontal : increment, Vertical : increment)                  */
+  #if (LANDSCAPE == 1)
+    /* AM=1   (address is updated in vertical writing direction)              */
+    wr_reg(0x03, 0x1038);
+  #else
+    /* AM=0   (address is updated in horizontal writing direction)            */
+    wr_reg(0x03, 0x1030);
+  #endif
+
+    wr_reg(0x07, 0x0137);               /* 262K color and display ON          */
+  }
+  LPC_GPIO4->FIOSET = 0x10000000;
+  reg_valid = 0;                        /* Controller state no longer known   */
+}
+
+
+/*******************************************************************************
+* Set draw window region                                                       *
+*   Parameter:      x:        horizontal position                              *
+*                   y:        vertical position                                *
+*                   w:        window width in pixel                            *
+*                   h:        window height in pixels                          *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_SetWindow (unsigned int x, unsigned int y, unsigned int w, unsigned int h) {
+  unsigned int xe, ye;
+
+  if (Himax) {
+    xe = x+w-1;
+    ye = y+h-1;
+
+    wr_reg_cached(0x02, x  >>    8);    /* Column address start MSB           */
+    wr_reg_cached(0x03, x  &  0xFF);    /* Column address start LSB           */
+    wr_reg_cached(0x04, xe >>    8);    /* Column address end MSB             */
+    wr_reg_cached(0x05, xe &  0xFF);    /* Column address end LSB             */
+  
+    wr_reg_cached(0x06, y  >>    8);    /* Row address start MSB              */
+    wr_reg_cached(0x07, y  &  0xFF);    /* Row address start LSB              */
+    wr_reg_cached(0x08, ye >>    8);    /* Row address end MSB                */
+    wr_reg_cached(0x09, ye &  0xFF);    /* Row address end LSB                */
+  }
+  else {
+   #if (LANDSCAPE == 1)
+    wr_reg_cached(0x50, y);             /* Vertical   GRAM Start Address      */
+    wr_reg_cached(0x51, y+h-1);         /* Vertical   GRAM End   Address (-1) */
+    wr_reg_cached(0x52, x);             /* Horizontal GRAM Start Address      */
+    wr_reg_cached(0x53, x+w-1);         /* Horizontal GRAM End   Address (-1) */
+    wr_reg_cached(0x20, y);
+    wr_reg_cached(0x21, x);
+   #else
+    wr_reg_cached(0x50, x);             /* Horizontal GRAM Start Address      */
+    wr_reg_cached(0x51, x+w-1);         /* Horizontal GRAM End   Address (-1) */
+    wr_reg_cached(0x52, y);             /* Vertical   GRAM Start Address      */
+    wr_reg_cached(0x53, y+h-1);         /* Vertical   GRAM End   Address (-1) */
+    wr_reg_cached(0x20, x);
+    wr_reg_cached(0x21, y);
+   #endif
+  }
+}
+
+
+/*******************************************************************************
+* Set draw window region to whole screen                                       *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_WindowMax (void) {
+  GLCD_SetWindow (0, 0, WIDTH, HEIGHT);
+}
+
+
+/*******************************************************************************
+* Draw a pixel in foreground color                                             *
+*   Parameter:      x:        horizontal position                              *
+*                   y:        vertical position                                *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_PutPixel (unsigned int x, unsigned int y) {
+
+  if (Himax) {
+    wr_reg_cached(0x02, x >>    8);     /* Column address start MSB           */
+    wr_reg_cached(0x03, x &  0xFF);     /* Column address start LSB           */
+    wr_reg_cached(0x04, x >>    8);     /* Column address end MSB             */
+    wr_reg_cached(0x05, x &  0xFF);     /* Column address end LSB             */
+  
+    wr_reg_cached(0x06, y >>    8);     /* Row address start MSB              */
+    wr_reg_cached(0x07, y &  0xFF);     /* Row address start LSB              */
+    wr_reg_cached(0x08, y >>    8);     /* Row address end MSB                */
+    wr_reg_cached(0x09, y &  0xFF);     /* Row address end LSB                */
+  }
+  else {
+   #if (LANDSCAPE == 1)
+    wr_reg_cached(0x20, y);
+    wr_reg_cached(0x21, x);
+   #else
+    wr_reg_cached(0x20, x);
+    wr_reg_cached(0x21, y);
+   #endif
+  }
+
+  wr_cmd(0x22);
+  wr_dat(Color[TXT_COLOR]);
+}
+
+
+/*******************************************************************************
+* Set foreground color                                                         *
+*   Parameter:      color:    foreground color                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_SetTextColor (unsigned short color) {
+
+  Color[TXT_COLOR] = color;
+}
+
+
+/*******************************************************************************
+* Set background color                                                         *
+*   Parameter:      color:    background color                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_SetBackColor (unsigned short color) {
+
+  Color[BG_COLOR] = color;
+}
+
+
+/*******************************************************************************
+* Clear display                                                                *
+*   Parameter:      color:    display clearing color                           *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_Clear (unsigned short color) {
+#if (USE_DMA == 1)
+  GLCD_WindowMax();
+  wr_cmd(0x22);
+  wr_px_start();
+
+  dma_fill = color;
+  dma_start((const unsigned short *)&dma_fill, WIDTH*HEIGHT, 1, 0, 0);
+#else
+  unsigned int i;
+
+  GLCD_WindowMax();
+  wr_cmd(0x22);
+  wr_px_start();
+
+  for(i = 0; i < (WIDTH*HEIGHT); i++)
+    wr_px(color);
+  wr_px_stop();
+#endif
+}
+
+
+/*******************************************************************************
+* Draw character on given position                                             *
+*   Parameter:      x:        horizontal position                              *
+*                   y:        vertical position                                *
+*                   cw:       character width in pixel                         *
+*                   ch:       character height in pixels                       *
+*                   c:        pointer to character bitmap                      *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_DrawChar (unsigned int x, unsigned int y, unsigned int cw, unsigned int ch, unsigned char *c) {
+  unsigned int i, j, k, pixs;
+
+  GLCD_SetWindow(x, y, cw, ch);
+
+  wr_cmd(0x22);
+  wr_px_start();
+
+  k  = (cw + 7)/8;
+
+  if (k == 1) {
+    for (j = 0; j < ch; j++) {
+      pixs = *(unsigned char  *)c;
+      c += 1;
+      
+      for (i = 0; i < cw; i++) {
+        wr_px (Color[(pixs >> i) & 1]);
+      }
+    }
+  }
+  else if (k == 2) {
+    for (j = 0; j < ch; j++) {
+      pixs = *(unsigned short *)c;
+      c += 2;
+      
+      for (i = 0; i < cw; i++) {
+        wr_px (Color[(pixs >> i) & 1]);
+      }
+    }
+  }
+  wr_px_stop();
+}
+
+
+/*******************************************************************************
+* Disply character on given line                                               *
+*   Parameter:      ln:       line number                                      *
+*                   col:      column number                                    *
+*                   fi:       font index (0 = 6x8, 1 = 16x24)                  *
+*                   c:        ascii character                                  *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_DisplayChar (unsigned int ln, unsigned int col, unsigned char fi, unsigned char c) {
+
+  c -= 32;
+  switch (fi) {
+    case 0:  /* Font 6 x 8 */
+      GLCD_DrawChar(col *  6, ln *  8,  6,  8, (unsigned char *)&Font_6x8_h  [c * 8]);
+      break;
+    case 1:  /* Font 16 x 24 */
+      GLCD_DrawChar(col * 16, ln * 24, 16, 24, (unsigned char *)&Font_16x24_h[c * 24]);
+      break;
+  }
+}
+
+
+/*******************************************************************************
+* Get the bitmap of a character                                                *
+*   Parameter:      fi:       font index (0 = 6x8, 1 = 16x24)                  *
+*                   c:        ascii character                                  *
+*   Return:                   pointer to the character rows, one row per       *
+*                             font element, bit 0 is the leftmost pixel        *
+*******************************************************************************/
+
+unsigned char *GLCD_CharBitmap (unsigned char fi, unsigned char c) {
+
+  c -= 32;
+  switch (fi) {
+    case 0:  /* Font 6 x 8 */
+      return ((unsigned char *)&Font_6x8_h  [c * 8]);
+    default: /* Font 16 x 24 */
+      return ((unsigned char *)&Font_16x24_h[c * 24]);
+  }
+}
+
+
+/*******************************************************************************
+* Disply string on given line                                                  *
+*   Parameter:      ln:       line number                                      *
+*                   col:      column number                                    *
+*                   fi:       font index (0 = 6x8, 1 = 16x24)                  *
+*                   s:        pointer to string                                *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_DisplayString (unsigned int ln, unsigned int col, unsigned char fi, unsigned char *s) {
+
+  while (*s) {
+    GLCD_DisplayChar(ln, col++, fi, *s++);
+  }
+}
+
+
+/*******************************************************************************
+* Clear given line                                                             *
+*   Parameter:      ln:       line number                                      *
+*                   fi:       font index (0 = 6x8, 1 = 16x24)                  *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_ClearLn (unsigned int ln, unsigned char fi) {
+  unsigned char i;
+  unsigned char buf[60];
+
+  GLCD_WindowMax();
+  switch (fi) {
+    case 0:  /* Font 6 x 8 */
+      for (i = 0; i < (WIDTH+5)/6; i++)
+        buf[i] = ' ';
+      buf[i+1] = 0;
+      break;
+    case 1:  /* Font 16 x 24 */
+      for (i = 0; i < (WIDTH+15)/16; i++)
+        buf[i] = ' ';
+      buf[i+1] = 0;
+      break;
+  }
+  GLCD_DisplayString (ln, 0, fi, buf);
+}
+
+/*******************************************************************************
+* Draw bargraph                                                                *
+*   Parameter:      x:        horizontal position                              *
+*                   y:        vertical position                                *
+*                   w:        maximum width of bargraph (in pixels)            *
+*                   h:        bargraph height                                  *
+*                   val:      value of active bargraph (in 1/1024)             *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_Bargraph (unsigned int x, unsigned int y, unsigned int w, unsigned int h, unsigned int val) {
+  unsigned int i,j;
+
+  val = (val * w) >> 10;                /* Scale value                        */
+  GLCD_SetWindow(x, y, w, h);
+  wr_cmd(0x22);
+  wr_px_start();
+  for (i = 0; i < h; i++) {
+    for (j = 0; j <= w-1; j++) {
+      if(j >= val) {
+        wr_px(Color[BG_COLOR]);
+      } else {
+        wr_px(Color[TXT_COLOR]);
+      }
+    }
+  }
+  wr_px_stop();
+}
+
+
+/*******************************************************************************
+* Display graphical bitmap image at position x horizontally and y vertically   *
+* (This function is optimized for 16 bits per pixel format, it has to be       *
+*  adapted for any other bits per pixel format)                                *
+* With USE_DMA large bitmaps are sent in the background: the bitmap must not   *
+* change until GLCD_Busy() returns 0                                           *
+*   Parameter:      x:        horizontal position                              *
+*                   y:        vertical position                                *
+*                   w:        width of bitmap                                  *
+*                   h:        height of bitmap                                 *
+*                   bitmap:   address at which the bitmap data resides         *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_Bitmap (unsigned int x, unsigned int y, unsigned int w, unsigned int h, unsigned char *bitmap) {
+  int i;
+  unsigned int j;
+  unsigned short *bitmap_ptr = (unsigned short *)bitmap;
+
+  GLCD_SetWindow (x, y, w, h);
+
+  wr_cmd(0x22);
+  wr_px_start();
+#if (USE_DMA == 1)
+  if (w*h >= DMA_MIN_PX) {              /* Rows are stored bottom-up          */
+    dma_start(&bitmap_ptr[(h-1)*w], w, h, -(int)w, 1);
+    return;
+  }
+#endif
+  for (i = (h-1)*w; i > -1; i -= w) {
+    for (j = 0; j < w; j++) {
+      wr_px (bitmap_ptr[i+j]);
+    }
+  }
+  wr_px_stop();
+}
+
+
+
+/*******************************************************************************
+* Scroll content of the whole display for dy pixels vertically                 *
+*   Parameter:      dy:       number of pixels for vertical scroll             *
+*   Return:                                                                    *
+*******************************************************************************/
+
+void GLCD_ScrollVertical (unsigned int dy) {
+#if (LANDSCAPE == 0)
+  static unsigned int y = 0;
+
+  y = y + dy;
+  while (y >= HEIGHT)
+    y -= HEIGHT;
+
+  if (Himax) {
+    wr_reg(0x01, 0x08);
+    wr_reg(0x14, y>>8);                 /* VSP MSB                            */
+    wr_reg(0x15, y&0xFF);               /* VSP LSB                            */
+  }
+  else {
+    wr_reg(0x6A, y);
+    wr_reg(0x61, 3);
+  }
+#endif
+}
+
+
+/*******************************************************************************
+* Write a command to the LCD controller                                        *
+*   Parameter:      cmd:      command to write to the LCD                      *
+*   Return:                                                                    *
+*******************************************************************************/
+void GLCD_WrCmd (unsigned char cmd) {
+  wr_cmd (cmd);
+}
+
+
+/*******************************************************************************
+* Write a value into LCD controller register                                   *
+*   Parameter:      reg:      lcd register address                             *
+*                   val:      value to write into reg                          *
+*   Return:                                                                    *
+*******************************************************************************/
+void GLCD_WrReg (unsigned char reg, unsigned short val) {
+  int idx = reg_index(reg);
+
+  wr_reg (reg, val);
+  if (idx >= 0) {
+    reg_shadow[idx] = val;
+    reg_valid |= (1 << idx);
+  }
+}
+
+
+/*******************************************************************************
+* Get the counters of window and cursor register writes                        *
+*   Parameter:      issued:   number of writes sent to the controller          *
+*                   elided:   number of writes skipped (value unchanged)       *
+*   Return:                                                                    *
+*******************************************************************************/
+void GLCD_RegStats (unsigned int *issued, unsigned int *elided) {
+  *issued = reg_issued;
+  *elided = reg_elided;
+}
+
+
+/*******************************************************************************
+* Check for a pixel burst still being sent in the background                   *
+*   Parameter:                                                                 *
+*   Return:         1 while the bus is busy, 0 otherwise                       *
+*******************************************************************************/
+unsigned char GLCD_Busy (void) {
+#if (USE_DMA == 1)
+  return (dma_busy);
+#else
+  return (0);
+#endif
+}
+
+
+/*******************************************************************************
+* Wait for a pixel burst sent in the background to finish                      *
+*   Parameter:                                                                 *
+*   Return:                                                                    *
+*******************************************************************************/
+void GLCD_Wait (void) {
+#if (USE_DMA == 1)
+  dma_wait();
+#endif
+}
+
+
+/*******************************************************************************
+* Set the function called (from the DMA interrupt) when a burst finishes       *
+*   Parameter:      done:     callback, NULL for none                          *
+*   Return:                                                                    *
+*******************************************************************************/
+void GLCD_SetDoneCallback (void (*done)(void)) {
+#if (USE_DMA == 1)
+  dma_done = done;
+#endif
+}
+
+
+/*******************************************************************************
+* Set the function called repeatedly while the driver waits for a burst        *
+*   Parameter:      idle:     wait function (e.g. blocks on an RTX event),     *
+*                             NULL to spin                                     *
+*   Return:                                                                    *
+*******************************************************************************/
+void GLCD_SetWaitHook (void (*idle)(void)) {
+#if (USE_DMA == 1)
+  dma_idle = idle;
+#endif
+}
+
+
+#if (USE_DMA == 1)
+/*******************************************************************************
+* GPDMA interrupt: chain the next row or part of a row, finish the burst       *
+*******************************************************************************/
+void DMA_IRQHandler (void) {
+
+  if (LPC_GPDMA->DMACIntErrStat & DMA_CH_MSK) {
+    LPC_GPDMA->DMACIntErrClr = DMA_CH_MSK;
+    dma_left = 0;                       /* Abort the burst                    */
+    dma_rows = 0;
+  }
+  LPC_GPDMA->DMACIntTCClear = DMA_CH_MSK;
+
+  if (dma_left == 0 && dma_rows) {      /* Row done, advance to the next one  */
+    dma_rows--;
+    dma_row += dma_stride;
+    dma_src  = dma_row;
+    dma_left = dma_w;
+  }
+  if (dma_left) {
+    dma_next();
+    return;
+  }
+
+  LPC_SSP1->DMACR = 0;
+  wr_px_stop();
+  dma_busy = 0;
+  if (dma_done) dma_done();
+}
+#endif
+/******************************************************************************/
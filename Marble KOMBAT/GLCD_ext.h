@@ -0,0 +1,21 @@
+/******************************************************************************/
+/* GLCD_ext.h: Extensions to the GLCD interface exported by                   */
+/*             GLCD_SPI_LPC1700.c                                             */
+/******************************************************************************/
+
+#ifndef _GLCD_EXT_H
+#define _GLCD_EXT_H
+
+/* Background (DMA) pixel bursts                                              */
+extern unsigned char GLCD_Busy            (void);
+extern void          GLCD_Wait            (void);
+extern void          GLCD_SetDoneCallback (void (*done)(void));
+extern void          GLCD_SetWaitHook     (void (*idle)(void));
+
+/* Font access for composing text off-screen                                  */
+extern unsigned char *GLCD_CharBitmap     (unsigned char fi, unsigned char c);
+
+/* Window and cursor register shadow counters                                 */
+extern void          GLCD_RegStats        (unsigned int *issued, unsigned int *elided);
+
+#endif /* _GLCD_EXT_H */
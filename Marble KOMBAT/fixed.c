@@ -0,0 +1,97 @@
+/******************************************************************************/
+/* fixed.c: Q16.16 fixed point sine and cosine tables, integer square root    */
+/*   One entry per whole degree over 0..FIXED_TRIG_MAX, negative angles come  */
+/*   from symmetry. Generated as round(65536 * sin(d)) and round(65536 *      */
+/*   cos(d)).                                                                 */
+/******************************************************************************/
+
+#include "fixed.h"
+
+/*---------------------------- Global variables ------------------------------*/
+
+static const Fixed sin_table[FIXED_TRIG_MAX + 1] = {
+       0,   1144,   2287,   3430,   4572,   5712,   6850,   7987,
+    9121,  10252,  11380,  12505,  13626,  14742,  15855,  16962,
+   18064,  19161,  20252,  21336,  22415,  23486,  24550,  25607,
+   26656,  27697,  28729,  29753,  30767,  31772,  32768,  33754,
+   34729,  35693,  36647,  37590,  38521,  39441,  40348,  41243,
+   42126,  42995,  43852,  44695,  45525,  46341,  47143,  47930,
+   48703,  49461,  50203,  50931,  51643,  52339,  53020,  53684,
+   54332,  54963,  55578,  56175,  56756
+};
+
+static const Fixed cos_table[FIXED_TRIG_MAX + 1] = {
+   65536,  65526,  65496,  65446,  65376,  65287,  65177,  65048,
+   64898,  64729,  64540,  64332,  64104,  63856,  63589,  63303,
+   62997,  62672,  62328,  61966,  61584,  61183,  60764,  60326,
+   59870,  59396,  58903,  58393,  57865,  57319,  56756,  56175,
+   55578,  54963,  54332,  53684,  53020,  52339,  51643,  50931,
+   50203,  49461,  48703,  47930,  47143,  46341,  45525,  44695,
+   43852,  42995,  42126,  41243,  40348,  39441,  38521,  37590,
+   36647,  35693,  34729,  33754,  32768
+};
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Clamp an angle to the tabulated range                                        *
+*   Parameter:    deg:    angle in degrees                                     *
+*   Return:               angle between -FIXED_TRIG_MAX and FIXED_TRIG_MAX     *
+*******************************************************************************/
+
+static int trig_clamp (int deg) {
+  if (deg >  FIXED_TRIG_MAX) return  FIXED_TRIG_MAX;
+  if (deg < -FIXED_TRIG_MAX) return -FIXED_TRIG_MAX;
+  return deg;
+}
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Sine of a whole number of degrees                                            *
+*   Parameter:    deg:    angle in degrees, clamped to +/-FIXED_TRIG_MAX       *
+*   Return:               sine in Q16.16                                       *
+*******************************************************************************/
+
+Fixed Fixed_Sin (int deg) {
+  deg = trig_clamp(deg);
+  return (deg < 0) ? -sin_table[-deg] : sin_table[deg];
+}
+
+/*******************************************************************************
+* Cosine of a whole number of degrees                                          *
+*   Parameter:    deg:    angle in degrees, clamped to +/-FIXED_TRIG_MAX       *
+*   Return:               cosine in Q16.16                                     *
+*******************************************************************************/
+
+Fixed Fixed_Cos (int deg) {
+  deg = trig_clamp(deg);
+  return cos_table[(deg < 0) ? -deg : deg];
+}
+
+/*******************************************************************************
+* Integer square root, one result bit per iteration without division          *
+*   Parameter:    n:      value to take the root of                            *
+*   Return:               floor(sqrt(n))                                       *
+*******************************************************************************/
+
+uint32_t Fixed_Isqrt (uint64_t n) {
+  uint64_t root = 0;
+  uint64_t bit  = (uint64_t)1 << 62;
+
+  while (bit > n) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (n >= root + bit) {
+      n    -= root + bit;
+      root  = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
+/******************************************************************************/
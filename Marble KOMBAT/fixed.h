@@ -0,0 +1,32 @@
+/******************************************************************************/
+/* fixed.h: Q16.16 fixed point arithmetic for the FPU-less Cortex-M3          */
+/*   Positions, distances and speeds are Q16.16, angles are whole degrees.    */
+/*   Sine and cosine are tabulated over -FIXED_TRIG_MAX..FIXED_TRIG_MAX.      */
+/******************************************************************************/
+
+#ifndef _FIXED_H
+#define _FIXED_H
+
+#include <stdint.h>
+
+typedef int32_t Fixed;
+
+#define FIXED_SHIFT     16
+#define FIXED_ONE       (1 << FIXED_SHIFT)
+#define FIXED_TRIG_MAX  60              /* Largest tabulated angle (degrees)  */
+
+/* Integer to Q16.16, and back rounding down                                  */
+#define TO_FIXED(n)           ((Fixed)(n) * FIXED_ONE)
+#define FIXED_INT(f)          ((int)((f) >> FIXED_SHIFT))
+
+/* num / den of two integers as Q16.16, for constants                         */
+#define FIXED_FRAC(num, den)  ((Fixed)(((int64_t)(num) << FIXED_SHIFT) / (den)))
+
+/* Product of two Q16.16 values                                               */
+#define FIXED_MUL(a, b)       ((Fixed)(((int64_t)(a) * (b)) >> FIXED_SHIFT))
+
+extern Fixed Fixed_Sin (int deg);
+extern Fixed Fixed_Cos (int deg);
+extern uint32_t Fixed_Isqrt (uint64_t n);
+
+#endif /* _FIXED_H */
@@ -0,0 +1,54 @@
+/******************************************************************************/
+/* hal.h: Board abstraction for the game                                      */
+/*   The inputs, LEDs, timers, input log output, atomic swap and barrier the  */
+/*   game needs, without their registers. hal_lpc17xx.c drives the MCB1700    */
+/*   board and host/hal_host.c stands in for it on a Linux host.              */
+/******************************************************************************/
+
+#ifndef _HAL_H
+#define _HAL_H
+
+#include <stdint.h>
+
+/* Potentiometer, 12-bit readings                                             */
+extern void     HAL_Pot_Init        (void);
+extern uint32_t HAL_Pot_Read        (void);
+
+/* Joystick, held in any direction                                            */
+extern void     HAL_Joystick_Init   (void);
+extern int      HAL_Joystick_Held   (void);
+
+/* Push button, pressed is called from interrupt context                      */
+extern void     HAL_Button_Init     (void (*pressed)(void));
+
+/* LEDs, two more lit from right to left for each multiplier up to 3          */
+extern void     HAL_LED_Init        (void);
+extern void     HAL_LED_Multiplier  (uint32_t multiplier);
+
+/* Free running microsecond timer, wraps at 2^32                              */
+extern void     HAL_Timer_Init      (void);
+extern uint32_t HAL_Timer_Read      (void);
+
+/* Free running cost counter for profiling, wraps at 2^32: CPU cycles on      */
+/* the board, nanoseconds of the thread's CPU time on the host. The renderer  */
+/* reports the cost of each frame it drew, the game logic run since the       */
+/* previous one included, the marble operations of that logic when built to   */
+/* count them (0 otherwise), and whether it drew a whole screen rather than   */
+/* just what moved                                                            */
+extern void     HAL_Cycles_Init     (void);
+extern uint32_t HAL_Cycles          (void);
+extern void     HAL_Frame_Done      (uint32_t cycles, uint32_t ops, int screen);
+
+/* Input logs: where recordings go, and a recording to replay instead of      */
+/* live play (NULL for none)                                                  */
+extern void     HAL_Log_Init        (void);
+extern void     HAL_Log_Write       (const uint8_t *data, uint32_t n);
+extern const uint8_t *HAL_Replay_Source (uint32_t *length);
+
+/* Atomically store a value, returning the value it replaced                  */
+extern uint32_t HAL_Atomic_Swap     (volatile uint32_t *word, uint32_t value);
+
+/* Complete memory accesses before any that follow, for lock-free handovers   */
+extern void     HAL_Barrier         (void);
+
+#endif /* _HAL_H */
@@ -0,0 +1,271 @@
+/******************************************************************************/
+/* hal_lpc17xx.c: Board abstraction for the MCB1700 (LPC1768)                 */
+/*   Potentiometer on AD0.2 (P0.25), joystick on P1.20, P1.23-P1.26, push     */
+/*   button on P2.10 (EINT3), LEDs on P1.28, P1.29, P1.31 and P2.2-P2.6.      */
+/*   The timer comes from timer.c, the LED pins are set up by led.c. Builds   */
+/*   with REPLAY_RECORD send input logs out of UART0 (P0.2) at 115200 baud,   */
+/*   polling the transmitter, and a log to replay is built in by defining     */
+/*   REPLAY_LOG as a file of comma separated bytes, such as the output of     */
+/*   xxd -i.                                                                  */
+/******************************************************************************/
+
+#include <lpc17xx.h>
+#include "led.h"
+#include "timer.h"
+#include "hal.h"
+
+#define JOYSTICK_PINS   0x07900000      /* P1.20, P1.23-P1.26, low when held  */
+#define BUTTON_PIN      (1 << 10)       /* P2.10                              */
+#define LED_PINS_1      0xB0000000      /* P1.28, P1.29, P1.31                */
+#define LED_PINS_2      0x0000007C      /* P2.2-P2.6                          */
+#define UART_THRE       0x20            /* Transmit holding register empty    */
+#define UART_FIFO       16              /* Transmit FIFO depth (bytes)        */
+
+/*---------------------------- Global variables ------------------------------*/
+
+static void (*button_pressed)(void);
+static volatile uint32_t frame_cycles, frame_cycles_peak;   /* For a debugger */
+static volatile uint32_t frame_ops;
+
+#ifdef REPLAY_LOG
+static const uint8_t replay_log[] = {
+#include REPLAY_LOG
+};
+#endif
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Power the ADC and route the potentiometer to AD0.2                           *
+*******************************************************************************/
+
+void HAL_Pot_Init (void) {
+  LPC_PINCON->PINSEL1 &= ~(0x03 << 18);
+  LPC_PINCON->PINSEL1 |=  (0x01 << 18);
+  LPC_SC->PCONP |= (1 << 12);
+  LPC_ADC->ADCR = (1 <<  2) |
+                  (4 <<  8) |
+                  (1 << 21);
+}
+
+/*******************************************************************************
+* Convert the potentiometer position, waiting for the conversion               *
+*   Return:               reading from 0 to 4095                               *
+*******************************************************************************/
+
+uint32_t HAL_Pot_Read (void) {
+  uint32_t reading;
+
+  LPC_ADC->ADCR |= (1 << 24);
+  do {
+    reading = LPC_ADC->ADGDR;
+  } while (!(reading & 0x80000000));
+
+  return (reading & 0x0000FFFF) >> 4;
+}
+
+/*******************************************************************************
+* Set the joystick pins as inputs                                              *
+*******************************************************************************/
+
+void HAL_Joystick_Init (void) {
+  LPC_GPIO1->FIODIR &= ~JOYSTICK_PINS;
+}
+
+/*******************************************************************************
+* Check the joystick                                                           *
+*   Return:               non-zero while it is held in any direction           *
+*******************************************************************************/
+
+int HAL_Joystick_Held (void) {
+  return (~LPC_GPIO1->FIOPIN & JOYSTICK_PINS) != 0;
+}
+
+/*******************************************************************************
+* Interrupt on the push button's falling edge                                  *
+*   Parameter:    pressed: called from the interrupt on each press             *
+*******************************************************************************/
+
+void HAL_Button_Init (void (*pressed)(void)) {
+  button_pressed = pressed;
+  LPC_GPIOINT->IO2IntEnF |=  BUTTON_PIN;
+  LPC_GPIOINT->IO2IntEnR &= ~BUTTON_PIN;
+  NVIC_EnableIRQ(EINT3_IRQn);
+}
+
+/*******************************************************************************
+* Push button interrupt, shared with the other GPIO interrupts on EINT3        *
+*******************************************************************************/
+
+void EINT3_IRQHandler (void) {
+  if (button_pressed) {
+    button_pressed();
+  }
+  LPC_GPIOINT->IO2IntClr |= BUTTON_PIN;
+}
+
+/*******************************************************************************
+* Set the LED pins as outputs                                                  *
+*******************************************************************************/
+
+void HAL_LED_Init (void) {
+  LED_setup();
+}
+
+/*******************************************************************************
+* Show a score multiplier on the LEDs                                          *
+*   Parameter:    multiplier: 0 to 3, anything larger leaves them all off      *
+*******************************************************************************/
+
+void HAL_LED_Multiplier (uint32_t multiplier) {
+  LPC_GPIO1->FIOCLR |= LED_PINS_1;
+  LPC_GPIO2->FIOCLR |= LED_PINS_2;
+
+  switch (multiplier) {
+    case 0: LPC_GPIO2->FIOSET |= 0x60;
+            break;
+
+    case 1: LPC_GPIO2->FIOSET |= 0x78;
+            break;
+
+    case 2: LPC_GPIO1->FIOSET |= 0x80000000;
+            LPC_GPIO2->FIOSET |= 0x7C;
+            break;
+
+    case 3: LPC_GPIO1->FIOSET |= 0xB0000000;
+            LPC_GPIO2->FIOSET |= 0x7C;
+            break;
+
+    default: break;
+  }
+}
+
+/*******************************************************************************
+* Start the microsecond timer                                                  *
+*******************************************************************************/
+
+void HAL_Timer_Init (void) {
+  timer_setup();
+}
+
+/*******************************************************************************
+* Read the microsecond timer                                                   *
+*   Return:               microseconds since HAL_Timer_Init                    *
+*******************************************************************************/
+
+uint32_t HAL_Timer_Read (void) {
+  return timer_read();
+}
+
+/*******************************************************************************
+* Start the DWT cycle counter                                                  *
+*******************************************************************************/
+
+void HAL_Cycles_Init (void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*******************************************************************************
+* Read the DWT cycle counter                                                   *
+*   Return:               CPU cycles since HAL_Cycles_Init                     *
+*******************************************************************************/
+
+uint32_t HAL_Cycles (void) {
+  return DWT->CYCCNT;
+}
+
+/*******************************************************************************
+* Keep the cost of the last frame, and of the dearest one not a whole screen   *
+*   Parameter:    cycles: CPU cycles the frame took                            *
+*                 ops:    marble operations of the game logic it includes      *
+*                 screen: non-zero if it drew a whole screen                   *
+*******************************************************************************/
+
+void HAL_Frame_Done (uint32_t cycles, uint32_t ops, int screen) {
+  frame_cycles = cycles;
+  frame_ops    = ops;
+  if (!screen && cycles > frame_cycles_peak) {
+    frame_cycles_peak = cycles;
+  }
+}
+
+/*******************************************************************************
+* Set up UART0 for 115200 baud 8N1 from the 25 MHz peripheral clock            *
+*   25 MHz / (16 * 9 * (1 + 1/2)) = 115741 baud                                *
+*******************************************************************************/
+
+void HAL_Log_Init (void) {
+  LPC_SC->PCONP |= (1 << 3);
+  LPC_PINCON->PINSEL0 &= ~(0x03 << 4);
+  LPC_PINCON->PINSEL0 |=  (0x01 << 4);          /* P0.2 is TXD0               */
+  LPC_UART0->LCR = 0x83;                        /* 8N1, divisor latch open    */
+  LPC_UART0->DLM = 0;
+  LPC_UART0->DLL = 9;
+  LPC_UART0->FDR = (2 << 4) | 1;                /* MULVAL 2, DIVADDVAL 1      */
+  LPC_UART0->LCR = 0x03;
+  LPC_UART0->FCR = 0x07;                        /* FIFOs on and cleared       */
+}
+
+/*******************************************************************************
+* Send input log bytes, a transmit FIFO full at a time                         *
+*   Waits for the FIFO to empty between fills, about 1.4 ms per 16 bytes, so   *
+*   only builds with REPLAY_RECORD call it                                     *
+*   Parameter:    data:   bytes to send                                        *
+*                 n:      number of bytes                                      *
+*******************************************************************************/
+
+void HAL_Log_Write (const uint8_t *data, uint32_t n) {
+  uint32_t i;
+
+  while (n > 0) {
+    while (!(LPC_UART0->LSR & UART_THRE));
+    for (i = 0; i < UART_FIFO && n > 0; i++, n--) {
+      LPC_UART0->THR = *data++;
+    }
+  }
+}
+
+/*******************************************************************************
+* Find the log built in to replay                                              *
+*   Parameter:    length: returned bytes in the log                            *
+*   Return:               the log, NULL if none was built in                   *
+*******************************************************************************/
+
+const uint8_t *HAL_Replay_Source (uint32_t *length) {
+#ifdef REPLAY_LOG
+  *length = sizeof(replay_log);
+  return replay_log;
+#else
+  *length = 0;
+  return 0;
+#endif
+}
+
+/*******************************************************************************
+* Atomically store a value with an exclusive load/store pair                   *
+*   Parameter:    word:   value to replace                                     *
+*                 value:  new value                                            *
+*   Return:               the value it replaced                                *
+*******************************************************************************/
+
+uint32_t HAL_Atomic_Swap (volatile uint32_t *word, uint32_t value) {
+  uint32_t old;
+
+  do {
+    old = __LDREXW(word);
+  } while (__STREXW(value, word));
+
+  return old;
+}
+
+/*******************************************************************************
+* Complete memory accesses before any that follow                              *
+*******************************************************************************/
+
+void HAL_Barrier (void) {
+  __DMB();
+}
+
+/******************************************************************************/
@@ -0,0 +1,7 @@
+/******************************************************************************/
+/* Font_16x24_h.h: Blank 16x24 font for the Linux host build                  */
+/*   The Keil font tables are not part of the project, so on the host every   */
+/*   glyph is blank and text draws as cells in its background colour.         */
+/******************************************************************************/
+
+static const unsigned short Font_16x24_h[(256 - 32) * 24];
@@ -0,0 +1,7 @@
+/******************************************************************************/
+/* Font_6x8_h.h: Blank 6x8 font for the Linux host build                      */
+/*   The Keil font tables are not part of the project, so on the host every   */
+/*   glyph is blank and text draws as cells in its background colour.         */
+/******************************************************************************/
+
+static const unsigned short Font_6x8_h[(256 - 32) * 8];
@@ -0,0 +1,48 @@
+/******************************************************************************/
+/* GLCD.h: Graphic LCD interface for the Linux host build                     */
+/*   Matches the MCB1700 GLCD.h the board build includes, implemented by the  */
+/*   board's GLCD_SPI_LPC1700.c against the register mock in lpc17xx.h.       */
+/******************************************************************************/
+
+#ifndef _GLCD_H
+#define _GLCD_H
+
+#define WIDTH       240                 /* Screen width in pixels             */
+#define HEIGHT      320                 /* Screen height in pixels            */
+
+/* GLCD RGB color definitions                                                 */
+#define Black       0x0000              /*   0,   0,   0                      */
+#define Navy        0x000F              /*   0,   0, 128                      */
+#define DarkGreen   0x03E0              /*   0, 128,   0                      */
+#define DarkCyan    0x03EF              /*   0, 128, 128                      */
+#define Maroon      0x7800              /* 128,   0,   0                      */
+#define Purple      0x780F              /* 128,   0, 128                      */
+#define Olive       0x7BE0              /* 128, 128,   0                      */
+#define LightGrey   0xC618              /* 192, 192, 192                      */
+#define DarkGrey    0x7BEF              /* 128, 128, 128                      */
+#define Blue        0x001F              /*   0,   0, 255                      */
+#define Green       0x07E0              /*   0, 255,   0                      */
+#define Cyan        0x07FF              /*   0, 255, 255                      */
+#define Red         0xF800              /* 255,   0,   0                      */
+#define Magenta     0xF81F              /* 255,   0, 255                      */
+#define Yellow      0xFFE0              /* 255, 255,   0                      */
+#define White       0xFFFF              /* 255, 255, 255                      */
+
+extern void GLCD_Init           (void);
+extern void GLCD_WindowMax      (void);
+extern void GLCD_PutPixel       (unsigned int x, unsigned int y);
+extern void GLCD_SetTextColor   (unsigned short color);
+extern void GLCD_SetBackColor   (unsigned short color);
+extern void GLCD_Clear          (unsigned short color);
+extern void GLCD_DrawChar       (unsigned int x, unsigned int y, unsigned int cw, unsigned int ch, unsigned char *c);
+extern void GLCD_DisplayChar    (unsigned int ln, unsigned int col, unsigned char fi, unsigned char c);
+extern void GLCD_DisplayString  (unsigned int ln, unsigned int col, unsigned char fi, unsigned char *s);
+extern void GLCD_ClearLn        (unsigned int ln, unsigned char fi);
+extern void GLCD_Bargraph       (unsigned int x, unsigned int y, unsigned int w, unsigned int h, unsigned int val);
+extern void GLCD_Bitmap         (unsigned int x, unsigned int y, unsigned int w, unsigned int h, unsigned char *bitmap);
+extern void GLCD_SetWindow      (unsigned int x, unsigned int y, unsigned int w, unsigned int h);
+extern void GLCD_ScrollVertical (unsigned int dy);
+extern void GLCD_WrCmd          (unsigned char cmd);
+extern void GLCD_WrReg          (unsigned char reg, unsigned short val);
+
+#endif /* _GLCD_H */
@@ -0,0 +1,151 @@
+/******************************************************************************/
+/* batch_cost.c: Batched bullet collision cost, on the Linux host             */
+/*   Builds the game with room for 8 bullets and 4 trains of 200 marbles and  */
+/*   times one Step_Bullets with HAL_Cycles, for 1 to 8 bullets in flight     */
+/*   against 1 to 4 trains. Every train is laid over the whole serpentine     */
+/*   track of track_bench.h, each a quarter spacing further along, so each    */
+/*   bullet has marbles of every train near its path. Bullet b waits one step */
+/*   below a marble of train b % trains on the bottom pass and hits it first. */
+/*   The hits are applied as in the game, a train taking one bullet a step,   */
+/*   so min(bullets, trains) join and the rest are held. Prints CSV, the      */
+/*   median of REPS runs per row, with the marble operations the step counted */
+/*   and the bullets that joined a train.                                     */
+/*                                                                            */
+/*   Build from the project directory, as the host build with this file in    */
+/*   place of main.c:                                                         */
+/*     cc -O2 -Wall -Wextra -Ihost -DCOUNT_LOGIC_OPS -DMAX_BULLETS=8          */
+/*        -DNUM_TRAINS=4 -DMAX_TRAIN=201 fixed.c track.c GLCD_List.c          */
+/*        replay.c GLCD_SPI_LPC1700.c host/hal_host.c host/rtx_host.c         */
+/*        host/lpc17xx_host.c host/batch_cost.c -o batch_cost                 */
+/******************************************************************************/
+
+#define main Game_Main                  /* The game's own entry is not used   */
+#include "../main.c"
+#undef main
+
+#include "track_bench.h"
+
+#define REPS            101             /* Runs per row, the median is kept   */
+#define LENGTH          200             /* Marbles per train                  */
+#define COST_SEED       0xACE1
+
+/*---------------------------- Global variables ------------------------------*/
+
+static Train    base[NUM_TRAINS];       /* Built trains, copied in each run   */
+static uint32_t overhead;               /* Cost of reading HAL_Cycles         */
+static uint32_t samples[REPS];
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Median of the samples, sorting them                                          *
+*******************************************************************************/
+
+static uint32_t median (void) {
+  uint32_t v;
+  int      i, j;
+
+  for (i = 1; i < REPS; i++) {
+    v = samples[i];
+    for (j = i; j > 0 && samples[j - 1] > v; j--) {
+      samples[j] = samples[j - 1];
+    }
+    samples[j] = v;
+  }
+  return samples[REPS / 2];
+}
+
+/*******************************************************************************
+* Lay a train of one segment over the bench track, as Train_Start does         *
+*   Parameter:    t:      train to fill                                        *
+*                 length: marbles, 0 for an empty train                        *
+*                 shift:  distance of its first marble past the usual start    *
+*******************************************************************************/
+
+static void build (Train *t, int length, Fixed shift) {
+  int i;
+
+  t->track        = &track_serpentine;
+  t->length       = length;
+  t->num_segments = (length > 0);
+  t->segment[0].first  = 0;
+  t->segment[0].offset = t->segment[0].prev_offset = TO_FIXED(MARBLE_DIAMETER) + shift;
+  for (i = 0; i < length; i++) {
+    t->colour[i] = Generate_Colour();
+  }
+  for (i = 0; i < length; i = Train_Rescan_Run(t, i) + 1);
+}
+
+/*******************************************************************************
+* Put the trains in play and fly bullets up at the bottom pass of the track,   *
+* each one step short of a marble of its own train. The other trains' marbles  *
+* there lie to the side and are reached later                                  *
+*   Parameter:    num:    bullets                                              *
+*                 trains: trains holding marbles                               *
+*******************************************************************************/
+
+static void aim_bullets (int num, int num_trains) {
+  Marble *marble;
+  Fixed   x, y;
+  int     b;
+
+  memcpy(trains, base, sizeof(trains));
+  Pool_Init();
+  memset(bullets, 0, sizeof(bullets));
+  score_multiplier = 0;
+  for (b = 0; b < num; b++) {
+    Track_Point(&track_serpentine,
+                Train_Distance(&trains[b % num_trains], LENGTH - 1 - b / num_trains), &x, &y);
+    bullets[b].marble = Pool_Alloc();
+    bullets[b].step_x = 0;
+    bullets[b].step_y = -BULLET_STEP;
+    marble = Marble_Get(bullets[b].marble);
+    marble->colour = RED;
+    Position_Marble(marble, x, y + TO_FIXED(MARBLE_DIAMETER) + BULLET_STEP / 2);
+    Save_Position(marble);
+  }
+}
+
+/************************ Exported functions **********************************/
+
+int main (void) {
+  static const int counts[] = { 1, 2, 4, 8 };
+  uint32_t start, ops;
+  int      b, n, r, i, joined;
+
+  HAL_Cycles_Init();
+  overhead = ~0u;
+  for (r = 0; r < REPS; r++) {
+    start = HAL_Cycles();
+    if (HAL_Cycles() - start < overhead) {
+      overhead = HAL_Cycles() - start;
+    }
+  }
+
+  printf("# unit=ns, MAX_BULLETS=%d, NUM_TRAINS=%d, MAX_TRAIN=%d\n", MAX_BULLETS, NUM_TRAINS, MAX_TRAIN);
+  printf("function,bullets,trains,marbles,joined,ops,cost\n");
+  for (n = 1; n <= NUM_TRAINS; n *= 2) {
+    seed = COST_SEED;
+    for (i = 0; i < NUM_TRAINS; i++) {
+      build(&base[i], i < n ? LENGTH : 0, i * MARBLE_SPACING / NUM_TRAINS);
+    }
+    for (i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])) && counts[i] <= MAX_BULLETS; i++) {
+      for (r = 0; r < REPS; r++) {
+        aim_bullets(counts[i], n);
+        ops   = logic_ops;
+        start = HAL_Cycles();
+        Step_Bullets();
+        samples[r] = HAL_Cycles() - start;
+        samples[r] = (samples[r] > overhead) ? samples[r] - overhead : 0;
+        ops = logic_ops - ops;
+      }
+      for (b = 0, joined = 0; b < MAX_BULLETS; b++) {
+        joined += (b < counts[i] && !bullets[b].marble);
+      }
+      printf("Step_Bullets,%d,%d,%d,%d,%u,%u\n", counts[i], n, n * LENGTH, joined, ops, median());
+    }
+  }
+  return 0;
+}
+
+/******************************************************************************/
@@ -0,0 +1,237 @@
+/******************************************************************************/
+/* display_list_test.c: Golden check of the game's display list               */
+/*   Plays the screens of a short game through the game's own recording and   */
+/*   rendering code: the title, the first game frame, a frame with the train  */
+/*   moved, the cannon turned and a bullet in flight, and the victory screen. */
+/*   Every command the LCD task replays is logged as a line, a bitmap by its  */
+/*   window and a hash of its pixels, and each screen's lines are checked     */
+/*   against host/golden/display_list.txt. Prints a line per screen and exits */
+/*   1 if any differs.                                                        */
+/*                                                                            */
+/*   After a deliberate change to what is drawn, rewrite the golden file with */
+/*     display_list_test -w                                                   */
+/*   and review its diff.                                                     */
+/*                                                                            */
+/*   The replays are logged by wrapping GLCD_List_Replay at link time. Build  */
+/*   from the project directory, as the host build with this file in place    */
+/*   of main.c:                                                               */
+/*     cc -O2 -Wall -Wextra -Ihost -Wl,--wrap=GLCD_List_Replay fixed.c        */
+/*        track.c GLCD_List.c replay.c GLCD_SPI_LPC1700.c host/hal_host.c     */
+/*        host/rtx_host.c host/lpc17xx_host.c host/display_list_test.c        */
+/*        -o display_list_test                                                */
+/******************************************************************************/
+
+#define main Game_Main                  /* The game's own entry is not used   */
+#include "../main.c"
+#undef main
+
+#include <stdarg.h>
+#include <lpc17xx.h>
+
+#define GOLDEN          "host/golden/display_list.txt"
+#define TEST_SEED       0xACE1
+#define LOG_SIZE        8192            /* Characters logged per screen       */
+
+/*---------------------------- Global variables ------------------------------*/
+
+static char  screen_log[LOG_SIZE];      /* Commands replayed for the screen   */
+static int   screen_len;
+static FILE *golden;                    /* Written with -w                    */
+static char  expected[4 * LOG_SIZE];    /* Golden file, read otherwise        */
+static char  header[64];
+static int   writing;
+static int   failed;
+
+static int   frame_cur;                 /* As in LCD_Display                  */
+static char  frame_score[SCORE_DIGITS + 1];
+
+extern unsigned int __real_GLCD_List_Replay (unsigned int n);
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Append a line to the screen's log                                            *
+*******************************************************************************/
+
+static void log_line (const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void log_line (const char *fmt, ...) {
+  va_list args;
+
+  va_start(args, fmt);
+  screen_len += vsnprintf(&screen_log[screen_len], LOG_SIZE - screen_len, fmt, args);
+  va_end(args);
+  if (screen_len >= LOG_SIZE - 1) {
+    screen_len = LOG_SIZE - 1;
+  }
+}
+
+/*******************************************************************************
+* FNV-1a hash of a bitmap's pixels                                             *
+*   Parameter:    bmp:    pixels                                               *
+*                 n:      number of pixels                                     *
+*   Return:               hash                                                 *
+*******************************************************************************/
+
+static uint32_t hash_pixels (const unsigned short *bmp, unsigned int n) {
+  uint32_t h = 2166136261u;
+
+  while (n--) {
+    h = (h ^ (*bmp & 0xFF)) * 16777619u;
+    h = (h ^ (*bmp >> 8))   * 16777619u;
+    bmp++;
+  }
+  return h;
+}
+
+/*******************************************************************************
+* Check the screen's log against its section of the golden file, or write it   *
+*   Parameter:    name:   screen, the section starts with a line "== name"     *
+*******************************************************************************/
+
+static void check_screen (const char *name) {
+  char *start, *end;
+  int   ok;
+
+  if (writing) {
+    fprintf(golden, "== %s\n%s", name, screen_log);
+    printf("wrote: %s\n", name);
+  } else {
+    snprintf(header, sizeof(header), "== %s\n", name);
+    start = strstr(expected, header);
+    ok    = (start != NULL);
+    if (ok) {
+      start += strlen(header);
+      end    = strstr(start, "\n== ");
+      end    = end ? end + 1 : start + strlen(start);
+      ok     = ((int)(end - start) == screen_len && memcmp(start, screen_log, screen_len) == 0);
+    }
+    printf("%s: %s display list\n", ok ? "pass" : "FAIL", name);
+    if (!ok) {
+      printf("%s", screen_log);
+      failed = 1;
+    }
+  }
+  screen_len    = 0;
+  screen_log[0] = '\0';
+}
+
+/*******************************************************************************
+* One pass of LCD_Display: replay what the game logic recorded, then draw the  *
+* latest game state                                                            *
+*******************************************************************************/
+
+static void display_pass (void) {
+
+  if (LCD_Replay()) {
+    GLCD_Wait();
+    num_sprites[frame_cur] = 0;
+    frame_score[0] = '\0';
+  }
+  Publish_Snapshot(SIM_ALPHA_ONE);
+  if (Acquire_Snapshot()->state == GAME_ON) {
+    frame_cur ^= 1;
+    Render_Frame(Acquire_Snapshot(), frame_cur, frame_score);
+  }
+}
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Log the commands replayed, then replay them                                  *
+*   Parameter:      n:        number of commands, from GLCD_List_Pending       *
+*   Return:                   number of display clears replayed                *
+*******************************************************************************/
+
+unsigned int __wrap_GLCD_List_Replay (unsigned int n) {
+  const GLCD_Cmd *cmd;
+  unsigned int    i;
+
+  for (i = 0; i < n && (cmd = GLCD_List_Peek(i)) != NULL; i++) {
+    switch (cmd->type) {
+      case GLCD_CMD_CLEAR:
+        log_line("clear %04X\n", cmd->color);
+        break;
+      case GLCD_CMD_BITMAP:
+        log_line("bitmap %u %u %u %u %08X\n", cmd->x, cmd->y, cmd->w, cmd->h,
+                 (unsigned int)hash_pixels(cmd->bitmap, cmd->w * cmd->h));
+        break;
+      case GLCD_CMD_TEXT:
+        log_line("text %u %u %u %04X %04X \"%s\"\n", cmd->y, cmd->x, cmd->font,
+                 cmd->color, cmd->back, cmd->text);
+        break;
+    }
+  }
+  return __real_GLCD_List_Replay(n);
+}
+
+/*******************************************************************************
+* Play the screens and check each                                              *
+*   Parameter:    -w to rewrite the golden file                                *
+*******************************************************************************/
+
+int main (int argc, char *argv[]) {
+  int i;
+
+  writing = (argc > 1 && strcmp(argv[1], "-w") == 0);
+  golden  = fopen(GOLDEN, writing ? "w" : "r");
+  if (golden == NULL) {
+    printf("FAIL: cannot open %s\n", GOLDEN);
+    return 1;
+  }
+  if (!writing) {
+    expected[fread(expected, 1, sizeof(expected) - 1, golden)] = '\0';
+  }
+
+  Mock_Reset();
+  GLCD_Init();
+  GLCD_SetWaitHook(Mock_Interrupts);
+  GLCD_Clear(BACKGROUND_COLOUR);
+
+  /* Title, as Game_Logic records it before the button is pressed             */
+  state = TITLE_SCREEN;
+  Record_Title_Screen();
+  display_pass();
+  check_screen("title");
+
+  /* The game starts as Game_Logic sets it up, from a fixed seed              */
+  state = GAME_ON;
+  Record_Game_Screen();
+  seed = TEST_SEED;
+  snprintf(score_str, sizeof(score_str), "%03u", (unsigned int)score);
+  Pool_Init();
+  chambered_colour = Generate_Colour();
+  spare_colour     = Generate_Colour();
+  for (i = 0; i < NUM_TRAINS; i++) {
+    Train_Start(&trains[i], level_tracks[i]);
+  }
+  cannon_angle = 0;
+  display_pass();
+  check_screen("first frame");
+
+  /* A second of play: the train moves on, the cannon turns and fires         */
+  cannon_angle = 30;
+  Fire_Bullet(cannon_angle);
+  for (i = 0; i < 1000000 / SIM_STEP_US; i++) {
+    Train_Save_Positions(&trains[0]);
+    Save_Position(Marble_Get(bullets[0].marble));
+    Move_Marble_Train(&trains[0], TRAIN_STEP);
+    Move_Bullet(&bullets[0]);
+  }
+  display_pass();
+  check_screen("train moved, bullet in flight");
+
+  /* Victory, recorded after leaving GAME_ON                                  */
+  score = 120;
+  snprintf(score_str, sizeof(score_str), "%03u", (unsigned int)score);
+  state = FATALITY;
+  Publish_Snapshot(SIM_ALPHA_ONE);
+  Record_End_Screen(true);
+  display_pass();
+  check_screen("victory");
+
+  fclose(golden);
+  return failed;
+}
+
+/******************************************************************************/
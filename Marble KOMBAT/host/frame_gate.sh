@@ -0,0 +1,27 @@
+#!/bin/sh
+# frame_gate.sh: Frame cost regression gate, on the Linux host
+#   Replays every scenario of the budget file through the host build and
+#   fails if any of them costs more per frame than its budget allows. The
+#   host CPU time per frame is budgeted with a tolerance wide enough for one
+#   run to pass on an idle machine; the logic operations and SPI traffic are
+#   counts and must match exactly. Each scenario is run once.
+#
+#   Run from the project directory, after building marble_host as in
+#   host/hal_host.c, with -DCOUNT_LOGIC_OPS:
+#     sh host/frame_gate.sh [marble_host [budget file]]
+#   To take new budgets, copy the measured line each run prints over the
+#   scenario's line in the budget file.
+
+HOST=${1:-./marble_host}
+BUDGET=${2:-host/frame_budget.txt}
+failed=0
+
+for name in $(awk '$1 !~ /^#/ && $1 != "tolerance" && NF == 13 { print $1 }' "$BUDGET"); do
+  if ! MARBLE_SCENARIO=$name MARBLE_BUDGET=$BUDGET "$HOST" > /tmp/frame_gate.$$; then
+    failed=1
+  fi
+  grep "^$name" /tmp/frame_gate.$$
+done
+rm -f /tmp/frame_gate.$$
+
+exit $failed
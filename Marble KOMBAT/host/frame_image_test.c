@@ -0,0 +1,189 @@
+/******************************************************************************/
+/* frame_image_test.c: Reference image check of the game's frames             */
+/*   Draws known game frames through the game's renderer, the display list    */
+/*   and the real LCD driver into the register mock's GRAM, and compares the  */
+/*   GRAM byte for byte with the PPM images in host/reference. The frames put */
+/*   bullets across each edge of the screen, where sprites are clipped, and   */
+/*   the second one moves everything so the first is repainted over. Prints   */
+/*   a line per frame and exits 1 if any differs. The host font is blank, so  */
+/*   the score shows as its background.                                       */
+/*                                                                            */
+/*   After a deliberate change to what is drawn, rewrite the images with      */
+/*     frame_image_test -w                                                    */
+/*   and look at them before checking them in.                                */
+/*                                                                            */
+/*   Build from the project directory, as the host build with this file in    */
+/*   place of main.c and a bullet for each edge:                              */
+/*     cc -O2 -Wall -Wextra -Ihost -DMAX_BULLETS=4 fixed.c track.c            */
+/*        GLCD_List.c replay.c GLCD_SPI_LPC1700.c host/hal_host.c             */
+/*        host/rtx_host.c host/lpc17xx_host.c host/frame_image_test.c         */
+/*        -o frame_image_test                                                 */
+/******************************************************************************/
+
+#define main Game_Main                  /* The game's own entry is not used   */
+#include "../main.c"
+#undef main
+
+#include <lpc17xx.h>
+
+#if MAX_BULLETS < 4
+#error "frame_image_test needs -DMAX_BULLETS=4 or more"
+#endif
+
+#define REFERENCE       "host/reference/"
+#define TEST_SEED       0xACE1
+#define PPM_HEAD        "P6\n240 320\n255\n"    /* As Mock_Save writes it     */
+
+/*---------------------------- Global variables ------------------------------*/
+
+static unsigned char image[MOCK_GRAM_H * MOCK_GRAM_W * 3];
+static int           writing;
+static int           failed;
+
+static int           frame_cur;         /* As in LCD_Display                  */
+static char          frame_score[SCORE_DIGITS + 1];
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* One pass of LCD_Display: replay what the game logic recorded, then draw the  *
+* latest game state                                                            *
+*******************************************************************************/
+
+static void display_pass (void) {
+
+  if (LCD_Replay()) {
+    GLCD_Wait();
+    num_sprites[frame_cur] = 0;
+    frame_score[0] = '\0';
+  }
+  Publish_Snapshot(SIM_ALPHA_ONE);
+  if (Acquire_Snapshot()->state == GAME_ON) {
+    frame_cur ^= 1;
+    Render_Frame(Acquire_Snapshot(), frame_cur, frame_score);
+  }
+  GLCD_Wait();
+}
+
+/*******************************************************************************
+* Check the GRAM against a reference image, or write it                        *
+*   Parameter:    name:   image file in host/reference                         *
+*******************************************************************************/
+
+static void check_frame (const char *name) {
+  char           path[128];
+  FILE          *f;
+  unsigned char *p = image;
+  unsigned short px;
+  int            x, y, ok, diff = 0, first = -1;
+
+  snprintf(path, sizeof(path), "%s%s", REFERENCE, name);
+  if (writing) {
+    ok = (Mock_Save(path) == 0);
+    printf("%s: %s\n", ok ? "wrote" : "FAIL: cannot write", path);
+    failed |= !ok;
+    return;
+  }
+
+  f  = fopen(path, "rb");
+  ok = (f != NULL);
+  if (ok) {
+    ok = (fread(image, 1, strlen(PPM_HEAD), f) == strlen(PPM_HEAD) &&
+          memcmp(image, PPM_HEAD, strlen(PPM_HEAD)) == 0 &&
+          fread(image, 1, sizeof(image), f) == sizeof(image));
+    fclose(f);
+  }
+  if (ok) {                             /* Colours expanded as Mock_Save does */
+    for (y = 0; y < MOCK_GRAM_H; y++) {
+      for (x = 0; x < MOCK_GRAM_W; x++, p += 3) {
+        px = Mock_GRAM[y][x];
+        if (p[0] != (((px >> 11) & 0x1F) << 3) ||
+            p[1] != (((px >>  5) & 0x3F) << 2) ||
+            p[2] != (( px        & 0x1F) << 3)) {
+          if (diff++ == 0) {
+            first = y * MOCK_GRAM_W + x;
+          }
+        }
+      }
+    }
+    ok = (diff == 0);
+  }
+  printf("%s: %s matches the reference\n", ok ? "pass" : "FAIL", name);
+  if (diff) {
+    printf("  %d pixels differ, the first at %d, %d\n", diff, first % MOCK_GRAM_W, first / MOCK_GRAM_W);
+  }
+  failed |= !ok;
+}
+
+/*******************************************************************************
+* Put a bullet in flight, centred at x, y, as if it had not moved              *
+*   Parameter:    b:      slot                                                 *
+*                 x, y:   centre (px)                                          *
+*******************************************************************************/
+
+static void place_bullet (int b, int x, int y) {
+  Marble *marble;
+
+  if (!bullets[b].marble) {
+    bullets[b].marble = Pool_Alloc();
+    Marble_Get(bullets[b].marble)->colour = Generate_Colour();
+  }
+  marble = Marble_Get(bullets[b].marble);
+  Position_Marble(marble, TO_FIXED(x), TO_FIXED(y));
+  Save_Position(marble);
+}
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Draw the frames and check each                                               *
+*   Parameter:    -w to rewrite the reference images                           *
+*******************************************************************************/
+
+int main (int argc, char *argv[]) {
+  int i;
+
+  writing = (argc > 1 && strcmp(argv[1], "-w") == 0);
+
+  Mock_Reset();
+  GLCD_Init();
+  GLCD_SetWaitHook(Mock_Interrupts);
+
+  /* The game starts as Game_Logic sets it up, from a fixed seed              */
+  state = GAME_ON;
+  Record_Game_Screen();
+  seed = TEST_SEED;
+  snprintf(score_str, sizeof(score_str), "%03u", (unsigned int)score);
+  Pool_Init();
+  chambered_colour = Generate_Colour();
+  spare_colour     = Generate_Colour();
+  for (i = 0; i < NUM_TRAINS; i++) {
+    Train_Start(&trains[i], level_tracks[i]);
+  }
+
+  /* Bullets clipped by the left, top, right and bottom edges                 */
+  cannon_angle = 20;
+  place_bullet(0, 2, 100);
+  place_bullet(1, 120, 3);
+  place_bullet(2, WINDOW_X - 3, 2 * STRIP_HEIGHT + 1);
+  place_bullet(3, 60, WINDOW_Y - 2);
+  display_pass();
+  check_frame("frame_edges.ppm");
+
+  /* Everything moves, the bullets off the edges and across strip boundaries  */
+  Train_Save_Positions(&trains[0]);
+  Move_Marble_Train(&trains[0], TO_FIXED(5));
+  cannon_angle = -35;
+  place_bullet(0, 9, 104);
+  place_bullet(1, 126, 10);
+  place_bullet(2, WINDOW_X - 9, 2 * STRIP_HEIGHT - 7);
+  place_bullet(3, 66, WINDOW_Y - 9);
+  score = 30;
+  snprintf(score_str, sizeof(score_str), "%03u", (unsigned int)score);
+  display_pass();
+  check_frame("frame_moved.ppm");
+
+  return failed;
+}
+
+/******************************************************************************/
@@ -0,0 +1,196 @@
+/******************************************************************************/
+/* glcd_test.c: Checks of the GLCD driver against the LPC17xx mock            */
+/*   Runs GLCD_SPI_LPC1700.c against the register mock in lpc17xx.h and       */
+/*   checks the bytes it shifts out, the register writes the shadows skip,    */
+/*   and what lands in the decoded GRAM, for the CPU path and for DMA bursts  */
+/*   chained over several channel set-ups. Prints a line per check and exits  */
+/*   1 if any failed.                                                         */
+/*                                                                            */
+/*   Build from the project directory:                                        */
+/*     cc -O2 -Wall -Wextra -Ihost GLCD_SPI_LPC1700.c host/lpc17xx_host.c     */
+/*        host/glcd_test.c -o glcd_test                                       */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <lpc17xx.h>
+#include "GLCD.h"
+#include "../GLCD_ext.h"
+
+/*---------------------------- Global variables ------------------------------*/
+
+static unsigned char  stream[256];
+static unsigned short bmp[WIDTH * 20];
+static int            failed;
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Report a check                                                               *
+*   Parameter:    ok:     non-zero if it passed                                *
+*                 what:   what was checked                                     *
+*******************************************************************************/
+
+static void check (int ok, const char *what) {
+
+  printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+  if (!ok) {
+    failed = 1;
+  }
+}
+
+/*******************************************************************************
+* Start a check from a full screen window                                      *
+*******************************************************************************/
+
+static void start (void) {
+
+  GLCD_WindowMax();
+  GLCD_Wait();
+  Mock_Reset();
+  Mock_Capture(stream, sizeof(stream));
+}
+
+/*******************************************************************************
+* Finish the calls under check                                                 *
+*******************************************************************************/
+
+static void finish (void) {
+
+  GLCD_Wait();
+  Mock_Sync();
+}
+
+/*******************************************************************************
+* Check that a GRAM rectangle holds a bitmap, bottom row first as GLCD_Bitmap  *
+* takes it, and that the pixels around it kept a colour                        *
+*   Parameter:    x, y, w, h: rectangle                                        *
+*                 src:        bitmap                                           *
+*                 around:     colour of the pixels around it                   *
+*   Return:                   non-zero if they do                              *
+*******************************************************************************/
+
+static int gram_holds (int x, int y, int w, int h, const unsigned short *src,
+                       unsigned short around) {
+  int i, j;
+
+  for (j = y - 1; j <= y + h; j++) {
+    for (i = x - 1; i <= x + w; i++) {
+      if (i < 0 || i >= WIDTH || j < 0 || j >= HEIGHT) {
+        continue;
+      }
+      if (i >= x && i < x + w && j >= y && j < y + h) {
+        if (Mock_GRAM[j][i] != src[(y + h - 1 - j) * w + (i - x)]) {
+          return 0;
+        }
+      } else if (Mock_GRAM[j][i] != around) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/*******************************************************************************
+* Check that the whole GRAM is one colour                                      *
+*   Parameter:    color:  colour                                               *
+*   Return:               non-zero if it is                                    *
+*******************************************************************************/
+
+static int gram_all (unsigned short color) {
+  int i, j;
+
+  for (j = 0; j < HEIGHT; j++) {
+    for (i = 0; i < WIDTH; i++) {
+      if (Mock_GRAM[j][i] != color) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Run the checks                                                               *
+*******************************************************************************/
+
+int main (void) {
+  /* GLCD_Bitmap(100, 100, 2, 2) after a full screen window and a GRAM access */
+  static const unsigned char bitmap_2x2[] = {
+    0x70, 0x00, 0x50, 0x72, 0x00, 0x64,   /* Window x 100..101                */
+    0x70, 0x00, 0x51, 0x72, 0x00, 0x65,
+    0x70, 0x00, 0x52, 0x72, 0x00, 0x64,   /* Window y 100..101                */
+    0x70, 0x00, 0x53, 0x72, 0x00, 0x65,
+    0x70, 0x00, 0x20, 0x72, 0x00, 0x64,   /* Address counter 100, 100         */
+    0x70, 0x00, 0x21, 0x72, 0x00, 0x64,
+    0x70, 0x00, 0x22,                     /* GRAM                             */
+    0x72, 0x33, 0x33, 0x44, 0x44,         /* Top row, the bitmap's last       */
+          0x11, 0x11, 0x22, 0x22
+  };
+  unsigned int issued, elided, prev_issued, prev_elided;
+  int          i;
+
+  Mock_Reset();
+  GLCD_Init();
+  GLCD_SetWaitHook(Mock_Interrupts);
+
+  check(Mock_Reg[0x03] == 0x1030, "GLCD_Init sets the portrait entry mode");
+
+  /* A register write is an index then a data transfer, each selected         */
+  start();
+  GLCD_WrReg(0x50, 0x000A);
+  finish();
+  check(Mock_Captured == 6 && memcmp(stream, "\x70\x00\x50\x72\x00\x0A", 6) == 0,
+        "GLCD_WrReg sends index and data transfers");
+  check(Mock_Count.selects == 2, "GLCD_WrReg selects the LCD twice");
+  check(Mock_Reg[0x50] == 0x000A, "GLCD_WrReg reaches the register");
+
+  /* Small bitmaps go out from the CPU, one 16-bit frame per pixel            */
+  start();
+  GLCD_Clear(0x0000);
+  GLCD_Wait();
+  Mock_Capture(stream, sizeof(stream));
+  bmp[0] = 0x1111; bmp[1] = 0x2222; bmp[2] = 0x3333; bmp[3] = 0x4444;
+  GLCD_Bitmap(100, 100, 2, 2, (unsigned char *)bmp);
+  finish();
+  check(Mock_Captured == sizeof(bitmap_2x2) &&
+        memcmp(stream, bitmap_2x2, sizeof(bitmap_2x2)) == 0,
+        "GLCD_Bitmap 2x2 byte stream");
+  check(gram_holds(100, 100, 2, 2, bmp, 0x0000), "GLCD_Bitmap 2x2 lands in the window");
+
+  /* The same window again only moves the address counter                     */
+  GLCD_RegStats(&prev_issued, &prev_elided);
+  Mock_Reset();
+  GLCD_Bitmap(100, 100, 2, 2, (unsigned char *)bmp);
+  finish();
+  GLCD_RegStats(&issued, &elided);
+  check(issued - prev_issued == 2 && elided - prev_elided == 4,
+        "GLCD_SetWindow skips the unchanged window registers");
+  check(Mock_Count.bytes == 2 * 6 + 3 + 1 + 4 * 2, "Repeated bitmap sends only the cursor and pixels");
+
+  /* A clear is one DMA burst chained over channel set-ups of 4095 pixels     */
+  start();
+  GLCD_Clear(0xF800);
+  finish();
+  check(Mock_Count.pixels == WIDTH * HEIGHT && Mock_Count.bursts == 1,
+        "GLCD_Clear writes every pixel in one GRAM access");
+  check(Mock_Count.bytes == 3 + 1 + 2 * WIDTH * HEIGHT, "GLCD_Clear byte count");
+  check(Mock_Count.selects == 2, "GLCD_Clear selects the LCD for the command and the burst");
+  check(gram_all(0xF800), "GLCD_Clear fills the GRAM");
+
+  /* A bitmap over DMA_MAX pixels is sent by DMA row by row, bottom row first */
+  for (i = 0; i < WIDTH * 20; i++) {
+    bmp[i] = (unsigned short)(i * 7);
+  }
+  start();
+  GLCD_Bitmap(0, 50, WIDTH, 20, (unsigned char *)bmp);
+  finish();
+  check(Mock_Count.pixels == WIDTH * 20, "GLCD_Bitmap 240x20 pixel count");
+  check(gram_holds(0, 50, WIDTH, 20, bmp, 0xF800), "GLCD_Bitmap 240x20 lands in the window");
+
+  return failed;
+}
+
+/******************************************************************************/
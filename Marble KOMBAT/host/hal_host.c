@@ -0,0 +1,416 @@
+/******************************************************************************/
+/* hal_host.c: Board abstraction for the Linux host build                     */
+/*   Inputs follow a fixed script on virtual ticks: the button starts the     */
+/*   game and then fires at intervals, the potentiometer sweeps end to end    */
+/*   and the joystick is nudged now and then. The microsecond timer is the    */
+/*   tick count, so the game runs as fast as the host can simulate it.        */
+/*                                                                            */
+/*   The LCD is the board's driver, GLCD_SPI_LPC1700.c, on the register mock  */
+/*   of lpc17xx_host.c. Its DMA interrupt is run by the kernel stand-in       */
+/*   whenever a task gives up the CPU.                                        */
+/*                                                                            */
+/*   Build from the project directory, the host headers come first:           */
+/*     cc -O2 -Wall -Wextra -DCOUNT_LOGIC_OPS -Ihost main.c fixed.c track.c   */
+/*        GLCD_List.c replay.c GLCD_SPI_LPC1700.c host/hal_host.c             */
+/*        host/rtx_host.c host/lpc17xx_host.c -o marble_host                  */
+/*   MARBLE_TICKS sets the ticks to run (default 100000), MARBLE_PPM a file   */
+/*   to save the last frame to, MARBLE_RECORD a file to write the input log   */
+/*   to when built with -DREPLAY_RECORD, and MARBLE_REPLAY a log to play back */
+/*   instead of the scripted inputs, either binary or as the comma separated  */
+/*   bytes the board builds in.                                               */
+/*                                                                            */
+/*   MARBLE_SCENARIO names a line of the budget file (MARBLE_BUDGET, default  */
+/*   host/frame_budget.txt) that gives the ticks and log to run, and the      */
+/*   frame costs the run must stay within:                                    */
+/*     name ticks log|- cycles cycles_p99 ops ops_peak bytes bytes_peak       */
+/*          selects selects_peak pixels pixels_peak                           */
+/*   cycles are the nanoseconds of CPU time HAL_Frame_Done was given for the  */
+/*   whole frame: rendering, the driver and mock, and the game logic since    */
+/*   the previous frame. ops are the game logic's marble operations when      */
+/*   built with -DCOUNT_LOGIC_OPS, bytes, selects and pixels the SPI bytes,   */
+/*   LCD chip selects and GRAM writes the mock decoded. All but cycles are    */
+/*   counts, the same on any host and run; cycles vary a little from run to   */
+/*   run and a lot between machines, so budgets for them are taken on the     */
+/*   machine that runs the gate.                                              */
+/*   Means are over every frame, peaks over the frames that were not whole    */
+/*   screens. The dearest frame's cycles are mostly a matter of when the host */
+/*   took an interrupt, so cycles_p99 is the 99th percentile over those       */
+/*   frames instead. A "tolerance cycles counts" line sets how many percent   */
+/*   above its budget a cycle figure and a count may go. The run prints what  */
+/*   it measured in the same form and exits with 1 if any figure is over.     */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <lpc17xx.h>
+#include "rtl.h"
+#include "../hal.h"
+
+#define HOST_TICK_US    10000           /* RTX tick, as OS_TICK on the board  */
+#define HOST_TICKS      100000          /* Default run length                 */
+#define START_TICK      10              /* Button press leaving the title     */
+#define FIRE_TICKS      30              /* Button presses after that          */
+#define POT_TICKS       400             /* Potentiometer sweep period         */
+#define JOY_TICKS       250             /* Joystick nudge period              */
+#define POT_MAX         4095
+#define BUDGET_FILE     "host/frame_budget.txt"
+#define NUM_COUNTS      5               /* Measured per frame, cycles first   */
+#define NUM_COSTS       10              /* Budgeted: each one's mean, peak    */
+
+/*---------------------------- Global variables ------------------------------*/
+
+static void     (*button_pressed)(void);
+static uint32_t  pot_reading;
+static int       joystick_held;
+static uint32_t  led_multiplier, led_changes;
+static uint32_t  run_ticks;
+static clock_t   run_start;
+static FILE     *log_file;
+static uint8_t  *replay_log;
+
+/* Frame costs, and the scenario they are checked against                     */
+static const char *const cost_name[NUM_COSTS] = {
+  "cycles", "cycles_p99", "ops", "ops_peak", "bytes", "bytes_peak",
+  "selects", "selects_peak", "pixels", "pixels_peak"
+};
+static uint32_t  frames;
+static uint64_t  frame_total[NUM_COUNTS];
+static uint32_t  frame_peak[NUM_COUNTS];
+static uint32_t *part_cycles;           /* Of each frame not a whole screen   */
+static uint32_t  parts, parts_room;
+static uint32_t  traffic_seen[3];       /* Mock_Count at the previous frame   */
+static char      scenario_log[256];
+static unsigned  budget[NUM_COSTS];
+static unsigned  tolerance[2];          /* Percent: cycles, counts            */
+static int       scenario;
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Order two frame costs, for qsort                                             *
+*******************************************************************************/
+
+static int cost_order (const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* 99th percentile of the cycles of the frames that were not whole screens      *
+*   Return:               cycles, 0 if there were none                         *
+*******************************************************************************/
+
+static uint32_t cycles_p99 (void) {
+
+  if (parts == 0) {
+    return 0;
+  }
+  qsort(part_cycles, parts, sizeof(part_cycles[0]), cost_order);
+  return part_cycles[(parts - 1) * 99 / 100];
+}
+
+/*******************************************************************************
+* Look the scenario up in the budget file                                      *
+*   Parameter:    name:   scenario name                                        *
+*   Return:               0 if the file or scenario is missing                 *
+*******************************************************************************/
+
+static int scenario_load (const char *name) {
+  const char *path = getenv("MARBLE_BUDGET") ? getenv("MARBLE_BUDGET") : BUDGET_FILE;
+  char        line[512], word[64];
+  FILE       *f;
+  int         found = 0;
+
+  if ((f = fopen(path, "r")) == NULL) {
+    printf("cannot read %s\n", path);
+    return 0;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "%63s", word) != 1 || word[0] == '#') {
+      continue;
+    }
+    if (strcmp(word, "tolerance") == 0) {
+      sscanf(line, "%*s %u %u", &tolerance[0], &tolerance[1]);
+    }
+    else if (strcmp(word, name) == 0 &&
+             sscanf(line, "%*s %u %255s %u %u %u %u %u %u %u %u %u %u", &run_ticks, scenario_log,
+                    &budget[0], &budget[1], &budget[2], &budget[3], &budget[4],
+                    &budget[5], &budget[6], &budget[7], &budget[8], &budget[9]) == 2 + NUM_COSTS) {
+      found = 1;
+    }
+  }
+  fclose(f);
+  if (!found) {
+    printf("no scenario %s in %s\n", name, path);
+  }
+  return found;
+}
+
+/*******************************************************************************
+* Compare the frame costs of the run with the scenario's budget                *
+*   Parameter:    name:   scenario name                                        *
+*   Return:               1 if every figure is within budget and tolerance     *
+*******************************************************************************/
+
+static int scenario_check (const char *name) {
+  unsigned cost[NUM_COSTS], limit, percent;
+  int      i, pass = 1;
+
+  for (i = 0; i < NUM_COUNTS; i++) {
+    cost[2 * i]     = frames ? frame_total[i] / frames : 0;
+    cost[2 * i + 1] = frame_peak[i];
+  }
+  cost[1] = cycles_p99();
+
+  printf("%s %u %s", name, run_ticks, scenario_log);
+  for (i = 0; i < NUM_COSTS; i++) {
+    printf(" %u", cost[i]);
+  }
+  printf("\n");
+  for (i = 0; i < NUM_COSTS; i++) {
+    percent = tolerance[i >= 2];
+    limit   = budget[i] + (uint64_t)budget[i] * percent / 100;
+    if (cost[i] > limit) {
+      printf("%s: %s %u over budget %u (+%u%%)\n", name, cost_name[i], cost[i], budget[i],
+             percent);
+      pass = 0;
+    }
+  }
+
+  /* A build that does not count them reports no logic operations at all      */
+  if (budget[2] > 0 && frame_total[1] == 0) {
+    printf("%s: no ops counted, build with -DCOUNT_LOGIC_OPS\n", name);
+    pass = 0;
+  }
+  printf("%s: %s in %u frames\n", name, pass ? "pass" : "FAIL", frames);
+  return pass;
+}
+
+/*******************************************************************************
+* Read a replay log written as comma separated bytes                           *
+*   Parameter:    text:   the file's contents, terminated                      *
+*                 log:    where the bytes go, as long as the text at least     *
+*   Return:               number of bytes                                      *
+*******************************************************************************/
+
+static uint32_t parse_bytes (const char *text, uint8_t *log) {
+  uint32_t n = 0;
+  char    *end;
+
+  while (*text) {
+    if (*text >= '0' && *text <= '9') {
+      log[n++] = (uint8_t)strtoul(text, &end, 0);
+      text = end;
+    }
+    else {
+      text++;
+    }
+  }
+  return n;
+}
+
+/*******************************************************************************
+* Print what the run cost, and save the screen if asked to                     *
+*******************************************************************************/
+
+static void host_report (uint32_t tick) {
+  double       secs = (double)(clock() - run_start) / CLOCKS_PER_SEC;
+  const char  *ppm = getenv("MARBLE_PPM");
+
+  Mock_Sync();
+  printf("ticks %u (%u s simulated) in %.3f s, %.0f ticks/s\n",
+         tick, tick / (1000000 / HOST_TICK_US), secs, secs > 0 ? tick / secs : 0.0);
+  printf("pixels %u, GRAM accesses %u, SPI bytes %u, selects %u, LED changes %u, multiplier %u\n",
+         Mock_Count.pixels, Mock_Count.bursts, Mock_Count.bytes, Mock_Count.selects,
+         led_changes, led_multiplier);
+  if (ppm && Mock_Save(ppm) != 0) {
+    printf("cannot save %s\n", ppm);
+  }
+  if (frames) {
+    printf("frames %u, per frame: host ns %llu (99%% %u, peak %u), ops %llu (peak %u), "
+           "SPI bytes %llu (peak %u), selects %llu (peak %u), pixels %llu (peak %u)\n",
+           frames, (unsigned long long)(frame_total[0] / frames), cycles_p99(), frame_peak[0],
+           (unsigned long long)(frame_total[1] / frames), frame_peak[1],
+           (unsigned long long)(frame_total[2] / frames), frame_peak[2],
+           (unsigned long long)(frame_total[3] / frames), frame_peak[3],
+           (unsigned long long)(frame_total[4] / frames), frame_peak[4]);
+  }
+}
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Run the interrupts due, called by the kernel stand-in before it picks a task *
+*******************************************************************************/
+
+void Host_Interrupts (void) {
+  Mock_Interrupts();
+}
+
+/*******************************************************************************
+* Drive the inputs for one virtual tick, called by the kernel stand-in         *
+*   Parameter:    tick:   ticks since os_sys_init                              *
+*   Return:               0 once the run is over                               *
+*******************************************************************************/
+
+int Host_Tick (uint32_t tick) {
+  uint32_t phase = tick % POT_TICKS;
+
+  if (run_ticks == 0) {
+    if (getenv("MARBLE_SCENARIO")) {
+      if (!scenario_load(getenv("MARBLE_SCENARIO"))) {
+        exit(2);
+      }
+      scenario = 1;
+    }
+    else {
+      run_ticks = getenv("MARBLE_TICKS") ? strtoul(getenv("MARBLE_TICKS"), NULL, 0) : HOST_TICKS;
+    }
+    run_start = clock();
+  }
+  if (tick >= run_ticks) {
+    host_report(tick);
+    if (scenario && !scenario_check(getenv("MARBLE_SCENARIO"))) {
+      exit(1);
+    }
+    return 0;
+  }
+
+  phase = (phase < POT_TICKS / 2) ? phase : POT_TICKS - phase;
+  pot_reading   = phase * POT_MAX / (POT_TICKS / 2);
+  joystick_held = (tick % JOY_TICKS) < 3;
+
+  if (button_pressed && (tick == START_TICK || (tick > START_TICK && tick % FIRE_TICKS == 0))) {
+    button_pressed();
+  }
+  return 1;
+}
+
+void HAL_Pot_Init (void) {
+}
+
+uint32_t HAL_Pot_Read (void) {
+  return pot_reading;
+}
+
+void HAL_Joystick_Init (void) {
+}
+
+int HAL_Joystick_Held (void) {
+  return joystick_held;
+}
+
+void HAL_Button_Init (void (*pressed)(void)) {
+  button_pressed = pressed;
+}
+
+void HAL_LED_Init (void) {
+}
+
+void HAL_LED_Multiplier (uint32_t multiplier) {
+  if (multiplier != led_multiplier) {
+    led_changes++;
+  }
+  led_multiplier = multiplier;
+}
+
+void HAL_Log_Init (void) {
+  const char *path = getenv("MARBLE_RECORD");
+
+  if (path) {
+    log_file = fopen(path, "wb");
+  }
+}
+
+void HAL_Log_Write (const uint8_t *data, uint32_t n) {
+  if (log_file) {
+    fwrite(data, 1, n, log_file);
+    fflush(log_file);
+  }
+}
+
+const uint8_t *HAL_Replay_Source (uint32_t *length) {
+  const char *path = scenario ? scenario_log : getenv("MARBLE_REPLAY");
+  FILE       *f;
+  long        size;
+
+  *length = 0;
+  if (path == NULL || strcmp(path, "-") == 0 || (f = fopen(path, "rb")) == NULL) {
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  replay_log = malloc(size + 1);
+  *length = fread(replay_log, 1, size, f);
+  fclose(f);
+
+  /* A binary log starts with its magic, anything else is text                */
+  if (*length > 0 && replay_log[0] != 'M') {
+    replay_log[*length] = '\0';
+    *length = parse_bytes((const char *)replay_log, replay_log);
+  }
+  return replay_log;
+}
+
+void HAL_Timer_Init (void) {
+}
+
+uint32_t HAL_Timer_Read (void) {
+  return Host_Ticks() * HOST_TICK_US;
+}
+
+void HAL_Cycles_Init (void) {
+}
+
+uint32_t HAL_Cycles (void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+}
+
+void HAL_Frame_Done (uint32_t cycles, uint32_t ops, int screen) {
+  uint32_t traffic[3], cost[NUM_COUNTS];
+  int      i;
+
+  /* The traffic counts are running totals, cycles and ops the frame's own    */
+  Mock_Sync();
+  traffic[0] = Mock_Count.bytes;
+  traffic[1] = Mock_Count.selects;
+  traffic[2] = Mock_Count.pixels;
+  cost[0] = cycles;
+  cost[1] = ops;
+  for (i = 0; i < 3; i++) {
+    cost[2 + i]     = traffic[i] - traffic_seen[i];
+    traffic_seen[i] = traffic[i];
+  }
+
+  frames++;
+  if (!screen) {
+    if (parts == parts_room) {
+      parts_room  = parts_room ? 2 * parts_room : 1024;
+      part_cycles = realloc(part_cycles, parts_room * sizeof(part_cycles[0]));
+    }
+    part_cycles[parts++] = cycles;
+  }
+  for (i = 0; i < NUM_COUNTS; i++) {
+    frame_total[i] += cost[i];
+    if (!screen && cost[i] > frame_peak[i]) {
+      frame_peak[i] = cost[i];
+    }
+  }
+}
+
+uint32_t HAL_Atomic_Swap (volatile uint32_t *word, uint32_t value) {
+  return __atomic_exchange_n(word, value, __ATOMIC_SEQ_CST);
+}
+
+void HAL_Barrier (void) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/******************************************************************************/
@@ -0,0 +1,313 @@
+/******************************************************************************/
+/* logic_cost.c: Game logic cost against train length, on the Linux host      */
+/*   Builds the game with a MAX_TRAIN large enough for synthetic trains from  */
+/*   7 to 10000 marbles and times the per-step work on each, with             */
+/*   HAL_Cycles: Move_Marble_Train, Move_Bullet flying clear, the collision   */
+/*   query Train_Sweep for that bullet's step, Step_Bullets with a bullet     */
+/*   that hits the train halfway along the track and is scored,               */
+/*   Collapse_Marbles at the middle of the train, Generate_Colour and the     */
+/*   front marble check of Game_Logic. Prints CSV, the median of REPS runs    */
+/*   per row, followed by the growth of each curve as an exponent of the      */
+/*   train length.                                                            */
+/*                                                                            */
+/*   Trains are laid in one of three colour distributions:                    */
+/*     random  colours from Generate_Colour, one segment                      */
+/*     pairs   runs of two, nothing collapses beyond the middle run           */
+/*     gapped  random, split every GAP_EVERY marbles by gaps that retract     */
+/*   Such long trains make main.c take 64-bit distances. Marbles past the     */
+/*   end of the track sit at its end, as in the game they never get there.    */
+/*   MAX_TRAIN leaves room for the bullet that hits the longest train, a      */
+/*   full train would lose it.                                                */
+/*                                                                            */
+/*   Build from the project directory, as the host build with this file in    */
+/*   place of main.c:                                                         */
+/*     cc -O2 -Ihost -DMAX_TRAIN=10001 fixed.c track.c GLCD_List.c replay.c   */
+/*        GLCD_SPI_LPC1700.c host/hal_host.c host/rtx_host.c                  */
+/*        host/lpc17xx_host.c host/logic_cost.c -lm -o logic_cost             */
+/******************************************************************************/
+
+#include <math.h>
+
+#define main Game_Main                  /* The game's own entry is not used   */
+#include "../main.c"
+#undef main
+
+#define REPS            101             /* Runs per row, the median is kept   */
+#define BATCH           1000            /* Calls per run of the cheap ones    */
+#define STEPS           16              /* Train moves per run, gaps stay open*/
+#define GAP_EVERY       8               /* Marbles between gaps (gapped)      */
+#define GAP             (2 * MARBLE_DIAMETER)
+#define COST_SEED       0xACE1
+
+enum { DIST_RANDOM, DIST_PAIRS, DIST_GAPPED, NUM_DISTS };
+enum { FN_MOVE_TRAIN, FN_MOVE_BULLET, FN_SWEEP, FN_BULLET_HIT, FN_COLLAPSE, FN_COLOUR, FN_FRONT,
+       NUM_FNS };
+
+/*---------------------------- Global variables ------------------------------*/
+
+static const char *const dist_name[NUM_DISTS] = { "random", "pairs", "gapped" };
+static const char *const fn_name[NUM_FNS] = {
+  "Move_Marble_Train", "Move_Bullet", "Train_Sweep", "Step_Bullets_hit", "Collapse_Marbles",
+  "Generate_Colour", "front_marble"
+};
+static const int lengths[] = { 7, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+
+static Train    base, work;             /* Built train, and a copy to change  */
+static uint32_t overhead;               /* Cost of reading HAL_Cycles         */
+static uint32_t samples[REPS];
+
+/* First and last measured point of each curve, for the exponent              */
+static int      fit_len[NUM_FNS][NUM_DISTS][2];
+static double   fit_cost[NUM_FNS][NUM_DISTS][2];
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Median of the samples, sorting them                                          *
+*******************************************************************************/
+
+static uint32_t median (void) {
+  uint32_t v;
+  int      i, j;
+
+  for (i = 1; i < REPS; i++) {
+    v = samples[i];
+    for (j = i; j > 0 && samples[j - 1] > v; j--) {
+      samples[j] = samples[j - 1];
+    }
+    samples[j] = v;
+  }
+  return samples[REPS / 2];
+}
+
+/*******************************************************************************
+* Time taken since a start reading, less the cost of the readings              *
+*******************************************************************************/
+
+static uint32_t since (uint32_t start) {
+  uint32_t dt = HAL_Cycles() - start;
+
+  return (dt > overhead) ? dt - overhead : 0;
+}
+
+/*******************************************************************************
+* Lay a train along the spiral in a colour distribution                        *
+*   Parameter:    t:      train to fill                                        *
+*                 length: marbles                                              *
+*                 dist:   DIST_RANDOM, DIST_PAIRS or DIST_GAPPED               *
+*******************************************************************************/
+
+static void build (Train *t, int length, int dist) {
+  static const Colour pair_colour[4] = { RED, BLUE, GREEN, YELLOW };
+  int64_t pos;
+  int     i, gapped = (dist == DIST_GAPPED);
+
+  seed = COST_SEED;
+  t->track = &track_spiral;
+  t->length = length;
+  t->num_segments = 0;
+  for (i = 0; i < length; i++) {
+    t->colour[i] = (dist == DIST_PAIRS) ? pair_colour[(i / 2) % 4] : Generate_Colour();
+    if (i == 0 || (gapped && i % GAP_EVERY == 0)) {
+      if (i > 0) {
+        t->colour[i] = t->colour[i - 1];        /* Drawn back across the gap  */
+      }
+      pos = MARBLE_DIAMETER + (int64_t)i * (MARBLE_DIAMETER - 1) + (int64_t)(i / GAP_EVERY) * GAP * gapped;
+      t->segment[t->num_segments].first = i;
+      t->segment[t->num_segments].offset = (Distance)pos * FIXED_ONE;
+      t->segment[t->num_segments].prev_offset = t->segment[t->num_segments].offset;
+      t->num_segments++;
+    }
+  }
+  for (i = 0; i < length; i = Train_Rescan_Run(t, i) + 1);
+}
+
+/*******************************************************************************
+* Make a run of three at a marble inside a segment, ready to collapse          *
+*   Parameter:    t:      train                                                *
+*   Return:               the marble to collapse at                            *
+*******************************************************************************/
+
+static int plant_run (Train *t) {
+  static const Colour pick[4] = { RED, BLUE, GREEN, YELLOW };
+  int mid = (t->length / 2 / GAP_EVERY) * GAP_EVERY + GAP_EVERY / 2;
+  int i;
+  Colour c = RED;
+
+  for (i = 0; i < 4; i++) {
+    c = pick[i];
+    if (c != t->colour[mid - 2] && c != t->colour[mid + 2]) {
+      break;
+    }
+  }
+  t->colour[mid - 1] = t->colour[mid] = t->colour[mid + 1] = c;
+  Train_Rescan_Run(t, mid - 2);
+  Train_Rescan_Run(t, mid);
+  Train_Rescan_Run(t, mid + 2);
+  return mid;
+}
+
+/*******************************************************************************
+* Put the train in play with a bullet one step short of hitting it, halfway    *
+* along the track or at the front of a shorter train                           *
+*******************************************************************************/
+
+static void aim_bullet (void) {
+  Marble *marble;
+  Fixed   x, y;
+  int     target;
+
+  trains[0] = base;
+  target = (base.track->length / 2 - TO_FIXED(MARBLE_DIAMETER)) / MARBLE_SPACING;
+  if (target >= base.length) {
+    target = base.length - 1;
+  }
+  Track_Point(base.track, ON_TRACK(base.track, Train_Distance(&base, target)), &x, &y);
+
+  Pool_Init();
+  memset(bullets, 0, sizeof(bullets));
+  bullets[0].marble = Pool_Alloc();
+  bullets[0].step_x = BULLET_STEP;
+  bullets[0].step_y = 0;
+  marble = Marble_Get(bullets[0].marble);
+  marble->colour = RED;
+  Position_Marble(marble, x - TO_FIXED(MARBLE_DIAMETER) - BULLET_STEP / 2, y);
+}
+
+/*******************************************************************************
+* Time one function on the built train                                         *
+*   Parameter:    fn:     FN_ function                                         *
+*   Return:               median cost of one call                              *
+*******************************************************************************/
+
+static double measure (int fn) {
+  Bullet   bullet;
+  uint32_t start, toi;
+  int      r, k, mid = 0, hit = 0;
+
+  if (fn == FN_COLLAPSE) {
+    mid = plant_run(&base);
+  }
+  for (r = 0; r < REPS; r++) {
+    switch (fn) {
+      case FN_MOVE_TRAIN:
+        work = base;
+        start = HAL_Cycles();
+        for (k = 0; k < STEPS; k++) {
+          Move_Marble_Train(&work, TRAIN_STEP);
+        }
+        samples[r] = since(start);
+        break;
+      case FN_COLLAPSE:
+        work = base;
+        start = HAL_Cycles();
+        Collapse_Marbles(&work, mid);
+        samples[r] = since(start);
+        break;
+      case FN_MOVE_BULLET:
+        Pool_Init();
+        bullet.marble = Pool_Alloc();
+        bullet.step_x = bullet.step_y = BULLET_STEP / 2;
+        Position_Marble(Marble_Get(bullet.marble), TO_FIXED(CANNON_X), TO_FIXED(CANNON_Y));
+        start = HAL_Cycles();
+        for (k = 0; k < BATCH; k++) {
+          Move_Bullet(&bullet);
+        }
+        samples[r] = since(start);
+        break;
+      case FN_SWEEP:
+        aim_bullet();
+        start = HAL_Cycles();
+        for (k = 0; k < BATCH; k++) {
+          hit = Train_Sweep(&trains[0], Marble_Get(bullets[0].marble), bullets[0].step_x,
+                            bullets[0].step_y, &toi);
+        }
+        samples[r] = since(start);
+        if (hit < 0) {
+          printf("# %s: the query found no hit\n", fn_name[fn]);
+        }
+        break;
+      case FN_BULLET_HIT:
+        aim_bullet();
+        start = HAL_Cycles();
+        Step_Bullets();
+        samples[r] = since(start);
+        if (bullets[0].marble || base.length == MAX_TRAIN) {
+          printf("# %s: the bullet %s\n", fn_name[fn], bullets[0].marble ? "missed" : "was lost to a full train");
+        }
+        break;
+      case FN_COLOUR:
+        start = HAL_Cycles();
+        for (k = 0; k < BATCH; k++) {
+          Generate_Colour();
+        }
+        samples[r] = since(start);
+        break;
+      case FN_FRONT:
+        start = HAL_Cycles();
+        for (k = 0; k < BATCH; k++) {
+          if (Train_Distance(&base, base.length - 1) >= base.track->length) {
+            state = YOU_DIED;
+          }
+        }
+        samples[r] = since(start);
+        break;
+    }
+  }
+  switch (fn) {
+    case FN_MOVE_TRAIN: return median() / (double)STEPS;
+    case FN_BULLET_HIT:
+    case FN_COLLAPSE:   return median();
+    default:            return median() / (double)BATCH;
+  }
+}
+
+/************************ Exported functions **********************************/
+
+int main (void) {
+  uint32_t start;
+  double   cost, grow;
+  int      i, d, f, r;
+
+  HAL_Cycles_Init();
+  overhead = ~0u;
+  for (r = 0; r < REPS; r++) {
+    start = HAL_Cycles();
+    if (HAL_Cycles() - start < overhead) {
+      overhead = HAL_Cycles() - start;
+    }
+  }
+
+  printf("# unit=ns, MAX_TRAIN=%d\n", MAX_TRAIN);
+  printf("function,distribution,marbles,segments,cost\n");
+  for (d = 0; d < NUM_DISTS; d++) {
+    for (i = 0; i < (int)(sizeof(lengths) / sizeof(lengths[0])) && lengths[i] <= MAX_TRAIN; i++) {
+      for (f = 0; f < NUM_FNS; f++) {
+        build(&base, lengths[i], d);
+        cost = measure(f);
+        printf("%s,%s,%d,%d,%.1f\n", fn_name[f], dist_name[d], base.length, base.num_segments, cost);
+        if (fit_len[f][d][0] == 0) {
+          fit_len[f][d][0] = lengths[i];
+          fit_cost[f][d][0] = cost;
+        }
+        fit_len[f][d][1] = lengths[i];
+        fit_cost[f][d][1] = cost;
+      }
+    }
+  }
+
+  /* Slope of the curve on log-log axes between its ends                      */
+  for (f = 0; f < NUM_FNS; f++) {
+    for (d = 0; d < NUM_DISTS; d++) {
+      if (fit_len[f][d][1] > fit_len[f][d][0] && fit_cost[f][d][0] > 0 && fit_cost[f][d][1] > 0) {
+        grow = log(fit_cost[f][d][1] / fit_cost[f][d][0]) /
+               log((double)fit_len[f][d][1] / fit_len[f][d][0]);
+        printf("# %s %s: n^%.2f from %d to %d marbles\n", fn_name[f], dist_name[d], grow,
+               fit_len[f][d][0], fit_len[f][d][1]);
+      }
+    }
+  }
+  return 0;
+}
+
+/******************************************************************************/
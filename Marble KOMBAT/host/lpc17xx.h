@@ -0,0 +1,121 @@
+/******************************************************************************/
+/* lpc17xx.h: Register mock of the LPC17xx for the Linux host build           */
+/*   Just the peripherals GLCD_SPI_LPC1700.c touches, implemented by          */
+/*   lpc17xx_host.c. SSP1, GPIO0 and the DMA controller are reached through   */
+/*   functions that first account for what was written since the previous    */
+/*   access: frames shifted out, chip selects and register writes. Stores to  */
+/*   read/write registers are only seen when they change the value,           */
+/*   write-only registers always are.                                         */
+/*   The SSP is never busy and each frame is received at once; an enabled     */
+/*   DMA channel completes at once and raises Mock_DMA_Pending until          */
+/*   Mock_Interrupts runs the DMA interrupt.                                  */
+/*                                                                            */
+/*   The bytes shifted out while the LCD is selected are decoded as an        */
+/*   ILI932x controller would take them, into its registers and a GRAM of     */
+/*   MOCK_GRAM_W x MOCK_GRAM_H pixels. Bytes the driver bit-bangs on GPIO to  */
+/*   read the controller ID are not decoded, and reads return 0.              */
+/******************************************************************************/
+
+#ifndef __LPC17xx_H__
+#define __LPC17xx_H__
+
+#include <stdint.h>
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+
+#define MOCK_GRAM_W     240             /* Controller GRAM size (pixels)      */
+#define MOCK_GRAM_H     320
+
+typedef enum {
+  DMA_IRQn = 26
+} IRQn_Type;
+
+typedef struct {
+  __IO uint32_t CR0;
+  __IO uint32_t CR1;
+  __IO uint32_t DR;
+  __I  uint32_t SR;
+  __IO uint32_t CPSR;
+  __IO uint32_t IMSC;
+  __IO uint32_t RIS;
+  __IO uint32_t MIS;
+  __O  uint32_t ICR;
+  __IO uint32_t DMACR;
+} LPC_SSP_TypeDef;
+
+typedef struct {
+  __IO uint32_t FIODIR;
+  __IO uint32_t FIOMASK;
+  __IO uint32_t FIOPIN;
+  __O  uint32_t FIOSET;
+  __O  uint32_t FIOCLR;
+} LPC_GPIO_TypeDef;
+
+typedef struct {
+  __IO uint32_t PINSEL0;
+  __IO uint32_t PINSEL9;
+  __IO uint32_t PINMODE0;
+} LPC_PINCON_TypeDef;
+
+typedef struct {
+  __IO uint32_t PCONP;
+  __IO uint32_t PCLKSEL0;
+} LPC_SC_TypeDef;
+
+typedef struct {
+  __I  uint32_t DMACIntErrStat;
+  __O  uint32_t DMACIntTCClear;
+  __O  uint32_t DMACIntErrClr;
+  __IO uint32_t DMACConfig;
+} LPC_GPDMA_TypeDef;
+
+/* Addresses are pointer sized, so the host can follow them                   */
+typedef struct {
+  __IO uintptr_t DMACCSrcAddr;
+  __IO uintptr_t DMACCDestAddr;
+  __IO uint32_t  DMACCLLI;
+  __IO uint32_t  DMACCControl;
+  __IO uint32_t  DMACCConfig;
+} LPC_GPDMACH_TypeDef;
+
+/* Traffic since Mock_Reset, after Mock_Sync                                  */
+typedef struct {
+  unsigned int bytes;                   /* Shifted out by SSP1, CPU or DMA    */
+  unsigned int selects;                 /* LCD chip select assertions         */
+  unsigned int writes;                  /* SSP1, GPIO0 and DMA register writes*/
+  unsigned int pixels;                  /* Decoded GRAM writes                */
+  unsigned int bursts;                  /* Decoded GRAM accesses (index 0x22) */
+} Mock_Traffic;
+
+extern LPC_SSP_TypeDef     *Mock_SSP1       (void);
+extern LPC_GPIO_TypeDef    *Mock_GPIO0      (void);
+extern LPC_GPDMA_TypeDef   *Mock_GPDMA      (void);
+extern LPC_GPDMACH_TypeDef *Mock_GPDMACH0   (void);
+extern void                 Mock_Sync       (void);
+extern void                 Mock_Reset      (void);
+extern void                 Mock_Interrupts (void);
+extern void                 Mock_Capture    (unsigned char *buf, unsigned int size);
+extern int                  Mock_Save       (const char *path);
+
+extern LPC_GPIO_TypeDef     Mock_GPIO4;
+extern LPC_PINCON_TypeDef   Mock_PINCON;
+extern LPC_SC_TypeDef       Mock_SC;
+extern Mock_Traffic         Mock_Count;
+extern int                  Mock_DMA_Pending;
+extern unsigned int         Mock_Captured;
+extern unsigned short       Mock_Reg[256];
+extern unsigned short       Mock_GRAM[MOCK_GRAM_H][MOCK_GRAM_W];
+
+#define LPC_SSP1            (Mock_SSP1())
+#define LPC_GPIO0           (Mock_GPIO0())
+#define LPC_GPDMA           (Mock_GPDMA())
+#define LPC_GPDMACH0        (Mock_GPDMACH0())
+#define LPC_GPIO4           (&Mock_GPIO4)
+#define LPC_PINCON          (&Mock_PINCON)
+#define LPC_SC              (&Mock_SC)
+
+#define NVIC_EnableIRQ(irq)
+
+#endif /* __LPC17xx_H__ */
@@ -0,0 +1,361 @@
+/******************************************************************************/
+/* lpc17xx_host.c: Register mock of the LPC17xx for the Linux host build      */
+/*   Counts the traffic GLCD_SPI_LPC1700.c puts on SSP1 and decodes it into   */
+/*   an ILI932x controller's registers and GRAM, see lpc17xx.h. Every         */
+/*   accessor first settles the stores made since the previous access to any */
+/*   peripheral, so chip selects, frames and DMA transfers are seen in the    */
+/*   order the driver made them.                                              */
+/*                                                                            */
+/*   Only the portrait set-up the driver uses is decoded: window registers    */
+/*   0x50-0x53, the GRAM address counter 0x20/0x21, GRAM data 0x22 and the    */
+/*   entry mode 0x03.                                                         */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <lpc17xx.h>
+
+#define DR_IDLE         0xFFFF0000      /* Never a frame the driver sends     */
+#define PIN_CS          (1 << 6)        /* LCD chip select on GPIO0           */
+#define SR_READY        0x03            /* TFE | TNF                          */
+#define SR_RNE          0x04
+
+/* Start byte of a transfer: 0x70 | RW | RS                                   */
+#define SPI_WR_INDEX    0x70
+#define SPI_WR_DATA     0x72
+
+/* Entry mode (0x03) bits                                                     */
+#define ENTRY_AM        0x0008          /* Address counter moves vertically   */
+#define ENTRY_ID0       0x0010          /* Horizontal increment               */
+#define ENTRY_ID1       0x0020          /* Vertical increment                 */
+
+/*---------------------------- Global variables ------------------------------*/
+
+LPC_GPIO_TypeDef    Mock_GPIO4;
+LPC_PINCON_TypeDef  Mock_PINCON;
+LPC_SC_TypeDef      Mock_SC;
+Mock_Traffic        Mock_Count;
+int                 Mock_DMA_Pending;
+unsigned int        Mock_Captured;
+unsigned short      Mock_Reg[256];
+unsigned short      Mock_GRAM[MOCK_GRAM_H][MOCK_GRAM_W];
+
+static LPC_SSP_TypeDef     ssp1 = { .DR = DR_IDLE };
+static LPC_GPIO_TypeDef    gpio0;
+static LPC_GPDMA_TypeDef   gpdma;
+static LPC_GPDMACH_TypeDef dmach0;
+
+/* Register values as last seen, to spot writes                               */
+static uint32_t  ssp1_seen[5], gpio0_seen, gpdma_seen, dmach0_seen[3];
+static uintptr_t dmach0_addr_seen[2];
+
+/* Controller side of the bus                                                 */
+static int            selected;         /* Chip select is low                 */
+static unsigned int   received;         /* Bytes since it went low            */
+static unsigned char  start_byte;
+static unsigned short word;             /* Data word being assembled          */
+static unsigned char  index_reg;        /* Register the data goes to          */
+static int            ac_x, ac_y;       /* GRAM address counter               */
+
+static unsigned char *capture;
+static unsigned int   capture_size;
+
+extern void DMA_IRQHandler (void);
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Count a write to a read/write register if its value changed                  *
+*   Parameter:    reg:    register                                             *
+*                 last:   value last seen                                      *
+*******************************************************************************/
+
+static void seen (volatile uint32_t *reg, uint32_t *last) {
+
+  if (*reg != *last) {
+    *last = *reg;
+    Mock_Count.writes++;
+  }
+}
+
+static void seen_addr (volatile uintptr_t *reg, uintptr_t *last) {
+
+  if (*reg != *last) {
+    *last = *reg;
+    Mock_Count.writes++;
+  }
+}
+
+/*******************************************************************************
+* Count a write to a write-only register and clear it for the next one         *
+*   Parameter:    reg:    register                                             *
+*   Return:               value written, 0 for none                            *
+*******************************************************************************/
+
+static uint32_t taken (volatile uint32_t *reg) {
+  uint32_t val = *reg;
+
+  if (val) {
+    *reg = 0;
+    Mock_Count.writes++;
+  }
+  return val;
+}
+
+/*******************************************************************************
+* Write a pixel at the GRAM address counter and move it through the window     *
+*   Parameter:    px:     pixel                                                *
+*******************************************************************************/
+
+static void gram_write (unsigned short px) {
+  unsigned short entry = Mock_Reg[0x03];
+  int hs = Mock_Reg[0x50], he = Mock_Reg[0x51];
+  int vs = Mock_Reg[0x52], ve = Mock_Reg[0x53];
+  int dx = (entry & ENTRY_ID0) ? 1 : -1;
+  int dy = (entry & ENTRY_ID1) ? 1 : -1;
+
+  if (ac_x >= 0 && ac_x < MOCK_GRAM_W && ac_y >= 0 && ac_y < MOCK_GRAM_H) {
+    Mock_GRAM[ac_y][ac_x] = px;
+  }
+  Mock_Count.pixels++;
+
+  if (entry & ENTRY_AM) {
+    ac_y += dy;
+    if (ac_y < vs || ac_y > ve) {
+      ac_y  = (dy > 0) ? vs : ve;
+      ac_x += dx;
+      if (ac_x < hs || ac_x > he) {
+        ac_x = (dx > 0) ? hs : he;
+      }
+    }
+  } else {
+    ac_x += dx;
+    if (ac_x < hs || ac_x > he) {
+      ac_x  = (dx > 0) ? hs : he;
+      ac_y += dy;
+      if (ac_y < vs || ac_y > ve) {
+        ac_y = (dy > 0) ? vs : ve;
+      }
+    }
+  }
+}
+
+/*******************************************************************************
+* Take a byte off the bus as the controller does                               *
+*   Parameter:    byte:   byte shifted out                                     *
+*******************************************************************************/
+
+static void decode (unsigned char byte) {
+
+  if (capture && Mock_Captured < capture_size) {
+    capture[Mock_Captured] = byte;
+  }
+  Mock_Captured++;
+
+  if (!selected) {
+    return;
+  }
+  if (received++ == 0) {
+    start_byte = byte;
+    return;
+  }
+  word = (word << 8) | byte;
+  if (!(received & 1)) {                /* Words follow the start byte        */
+    return;
+  }
+
+  if (start_byte == SPI_WR_INDEX) {
+    index_reg = word & 0xFF;
+    if (index_reg == 0x22) {
+      Mock_Count.bursts++;
+    }
+  } else if (start_byte == SPI_WR_DATA) {
+    if (index_reg == 0x22) {
+      gram_write(word);
+      return;
+    }
+    Mock_Reg[index_reg] = word;
+    if (index_reg == 0x20) ac_x = word;
+    if (index_reg == 0x21) ac_y = word;
+  }
+}
+
+/*******************************************************************************
+* Shift one SSP frame out, its size set by the DSS field                       *
+*   Parameter:    frame:  frame sent                                           *
+*******************************************************************************/
+
+static void shift (uint32_t frame) {
+
+  if ((ssp1.CR0 & 0x0F) > 7) {
+    Mock_Count.bytes += 2;
+    decode(frame >> 8);
+    decode(frame & 0xFF);
+  } else {
+    Mock_Count.bytes += 1;
+    decode(frame);
+  }
+}
+
+/*******************************************************************************
+* Settle the stores made since the previous access to any peripheral           *
+*******************************************************************************/
+
+static void settle (void) {
+  const volatile unsigned short *src;
+  uint32_t set, clr, n;
+  int      sent;
+
+  /* GPIO0: the chip select frames a transfer                                 */
+  seen(&gpio0.FIODIR, &gpio0_seen);
+  set = taken(&gpio0.FIOSET);
+  clr = taken(&gpio0.FIOCLR);
+  if (set & PIN_CS) {
+    selected = 0;
+  }
+  if (clr & PIN_CS) {
+    Mock_Count.selects++;
+    selected = 1;
+    received = 0;
+  }
+
+  /* SSP1: a frame written to DR goes out at once                             */
+  sent = (ssp1.DR != DR_IDLE);
+  if (sent) {
+    shift(ssp1.DR);
+    Mock_Count.writes++;
+    ssp1.DR = DR_IDLE;
+  }
+  seen(&ssp1.CR0,   &ssp1_seen[0]);
+  seen(&ssp1.CR1,   &ssp1_seen[1]);
+  seen(&ssp1.CPSR,  &ssp1_seen[2]);
+  seen(&ssp1.IMSC,  &ssp1_seen[3]);
+  seen(&ssp1.DMACR, &ssp1_seen[4]);
+  taken(&ssp1.ICR);
+  *(volatile uint32_t *)&ssp1.SR = SR_READY | (sent ? SR_RNE : 0);
+
+  /* GPDMA                                                                    */
+  seen(&gpdma.DMACConfig, &gpdma_seen);
+  taken(&gpdma.DMACIntTCClear);
+  taken(&gpdma.DMACIntErrClr);
+
+  /* Channel 0: enabled, it moves 16-bit words from memory into SSP1          */
+  seen_addr(&dmach0.DMACCSrcAddr,  &dmach0_addr_seen[0]);
+  seen_addr(&dmach0.DMACCDestAddr, &dmach0_addr_seen[1]);
+  seen(&dmach0.DMACCLLI,     &dmach0_seen[0]);
+  seen(&dmach0.DMACCControl, &dmach0_seen[1]);
+  seen(&dmach0.DMACCConfig,  &dmach0_seen[2]);
+  if (dmach0.DMACCConfig & 1) {
+    src = (const volatile unsigned short *)dmach0.DMACCSrcAddr;
+    for (n = dmach0.DMACCControl & 0x0FFF; n > 0; n--) {
+      shift(*src);
+      if (dmach0.DMACCControl & (1 << 26)) {
+        src++;
+      }
+    }
+    dmach0.DMACCConfig &= ~1;
+    dmach0_seen[2] = dmach0.DMACCConfig;
+    Mock_DMA_Pending = 1;
+  }
+}
+
+/************************ Exported functions **********************************/
+
+/* Register accessors of lpc17xx.h, see there                                 */
+
+LPC_SSP_TypeDef *Mock_SSP1 (void) {
+  settle();
+  return &ssp1;
+}
+
+LPC_GPIO_TypeDef *Mock_GPIO0 (void) {
+  settle();
+  return &gpio0;
+}
+
+LPC_GPDMA_TypeDef *Mock_GPDMA (void) {
+  settle();
+  return &gpdma;
+}
+
+LPC_GPDMACH_TypeDef *Mock_GPDMACH0 (void) {
+  settle();
+  return &dmach0;
+}
+
+/*******************************************************************************
+* Account for the stores made since the last access                            *
+*******************************************************************************/
+
+void Mock_Sync (void) {
+  settle();
+}
+
+/*******************************************************************************
+* Start counting the traffic from zero, the GRAM and registers are kept        *
+*******************************************************************************/
+
+void Mock_Reset (void) {
+  settle();
+  memset(&Mock_Count, 0, sizeof(Mock_Count));
+}
+
+/*******************************************************************************
+* Run the DMA interrupt for every transfer that finished, as the NVIC would    *
+* Installed as the driver's wait hook where nothing else runs meanwhile        *
+*******************************************************************************/
+
+void Mock_Interrupts (void) {
+
+  settle();
+  while (Mock_DMA_Pending) {
+    Mock_DMA_Pending = 0;
+    DMA_IRQHandler();
+    settle();
+  }
+}
+
+/*******************************************************************************
+* Keep a copy of the bytes shifted out from now on                             *
+*   Parameter:    buf:    where to copy them, NULL to stop                     *
+*                 size:   bytes it holds, later ones are only counted          *
+*   Mock_Captured counts the bytes, also those that did not fit                *
+*******************************************************************************/
+
+void Mock_Capture (unsigned char *buf, unsigned int size) {
+
+  settle();
+  capture       = buf;
+  capture_size  = size;
+  Mock_Captured = 0;
+}
+
+/*******************************************************************************
+* Save the GRAM as a binary PPM                                                *
+*   Parameter:    path:   file to write                                        *
+*   Return:               0 on success                                         *
+*******************************************************************************/
+
+int Mock_Save (const char *path) {
+  FILE          *f;
+  unsigned int   x, y;
+  unsigned short px;
+
+  settle();
+  f = fopen(path, "wb");
+  if (f == NULL) {
+    return -1;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", MOCK_GRAM_W, MOCK_GRAM_H);
+  for (y = 0; y < MOCK_GRAM_H; y++) {
+    for (x = 0; x < MOCK_GRAM_W; x++) {
+      px = Mock_GRAM[y][x];
+      fputc(((px >> 11) & 0x1F) << 3, f);
+      fputc(((px >>  5) & 0x3F) << 2, f);
+      fputc(( px        & 0x1F) << 3, f);
+    }
+  }
+  return fclose(f);
+}
+
+/******************************************************************************/
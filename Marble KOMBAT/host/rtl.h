@@ -0,0 +1,57 @@
+/******************************************************************************/
+/* rtl.h: RTX kernel stand-in for the Linux host build                        */
+/*   The subset of the RTX API the game uses, run by a cooperative scheduler  */
+/*   on virtual ticks in rtx_host.c. Tasks switch only when they wait, so a   */
+/*   task must never spin without calling the kernel.                         */
+/******************************************************************************/
+
+#ifndef _RTL_H
+#define _RTL_H
+
+#include <stdint.h>
+
+#define __task                          /* Tasks are plain functions          */
+
+typedef uint8_t  U8;
+typedef uint16_t U16;
+typedef uint32_t U32;
+typedef uint32_t OS_TID;                /* Task slot plus one, 0 for none     */
+typedef uint32_t OS_RESULT;
+typedef void    *OS_ID;
+
+typedef struct {
+  OS_TID        owner;
+  unsigned int  count;                  /* Nested waits by the owner          */
+} OS_MUT;
+
+#define OS_R_TMO        0x01
+#define OS_R_EVT        0x02
+#define OS_R_MUT        0x05
+#define OS_R_OK         0x00
+
+/* Task management                                                            */
+extern void      os_sys_init        (void (*task)(void));
+extern OS_TID    os_tsk_create      (void (*task)(void), U8 priority);
+extern void      os_tsk_delete_self (void);
+extern void      os_tsk_pass        (void);
+extern OS_TID    os_tsk_self        (void);
+
+/* Events                                                                     */
+extern OS_RESULT os_evt_wait_or     (U16 wait_flags, U16 timeout);
+extern void      os_evt_set         (U16 event_flags, OS_TID task_id);
+extern void      isr_evt_set        (U16 event_flags, OS_TID task_id);
+
+/* Mutexes                                                                    */
+extern void      os_mut_init        (OS_ID mutex);
+extern OS_RESULT os_mut_wait        (OS_ID mutex, U16 timeout);
+extern OS_RESULT os_mut_release     (OS_ID mutex);
+
+/* Time                                                                       */
+extern void      os_dly_wait        (U16 delay_time);
+extern void      os_itv_set         (U16 interval_time);
+extern void      os_itv_wait        (void);
+
+/* Host extensions                                                            */
+extern uint32_t  Host_Ticks         (void);
+
+#endif /* _RTL_H */
@@ -0,0 +1,280 @@
+/******************************************************************************/
+/* rtx_host.c: Cooperative RTX stand-in for the Linux host build              */
+/*   Each task runs on its own stack with ucontext and keeps the CPU until    */
+/*   it waits. When every task is waiting the virtual tick advances at once,  */
+/*   so delays and intervals take no real time. Ready tasks are run round     */
+/*   robin, priorities are ignored. Interrupts are only taken between tasks,  */
+/*   before each pick of the next one.                                        */
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <ucontext.h>
+#include "rtl.h"
+
+#define HOST_TASKS      8               /* Tasks alive at once                */
+#define HOST_STACK      (256 * 1024)    /* Stack per task (bytes)             */
+#define HOST_FOREVER    0xFFFF          /* Timeout that never expires         */
+
+#define TSK_FREE        0
+#define TSK_READY       1
+#define TSK_WAIT_EVT    2
+#define TSK_WAIT_DLY    3
+
+typedef struct {
+  void        (*entry)(void);
+  ucontext_t    ctx;
+  char         *stack;
+  int           state;
+  U16           events;                 /* Event flags set on the task        */
+  U16           wait_flags;             /* Flags it waits for, any of them    */
+  int           timed;                  /* Wakes at wake_tick if not before   */
+  uint32_t      wake_tick;
+  U16           interval;               /* os_itv_set period, 0 if not set    */
+  uint32_t      next_itv;
+  OS_RESULT     result;                 /* Returned when it resumes           */
+} Host_Task;
+
+/* Supplied by the board stand-in, called once a tick, 0 stops the kernel     */
+extern int  Host_Tick       (uint32_t tick);
+
+/* Supplied by the board stand-in, runs the interrupt handlers due            */
+extern void Host_Interrupts (void);
+
+/*---------------------------- Global variables ------------------------------*/
+
+static Host_Task  tasks[HOST_TASKS];
+static ucontext_t kernel_ctx;
+static int        current = -1;         /* Running task, -1 in the kernel     */
+static uint32_t   ticks;
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Give the CPU back to the kernel until the task is made ready                 *
+*   Return:               the result set when it was made ready                *
+*******************************************************************************/
+
+static OS_RESULT task_switch (void) {
+  Host_Task *t = &tasks[current];
+
+  swapcontext(&t->ctx, &kernel_ctx);
+  return t->result;
+}
+
+/*******************************************************************************
+* Make a waiting task ready                                                    *
+*   Parameter:    t:      task                                                 *
+*                 result: returned by the call it waits in                     *
+*******************************************************************************/
+
+static void task_ready (Host_Task *t, OS_RESULT result) {
+  t->state  = TSK_READY;
+  t->timed  = 0;
+  t->result = result;
+}
+
+/*******************************************************************************
+* First call on a task's stack                                                 *
+*******************************************************************************/
+
+static void task_start (void) {
+  tasks[current].entry();
+  os_tsk_delete_self();
+}
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Start the kernel with one task, returning when no task can run again or     *
+* Host_Tick stops it                                                           *
+*******************************************************************************/
+
+void os_sys_init (void (*task)(void)) {
+  int last = HOST_TASKS - 1, i, k, waiting;
+
+  os_tsk_create(task, 1);
+  for (;;) {
+    Host_Interrupts();
+
+    /* Next ready task after the last one run                                 */
+    for (k = 1; k <= HOST_TASKS; k++) {
+      i = (last + k) % HOST_TASKS;
+      if (tasks[i].state == TSK_READY) {
+        break;
+      }
+    }
+    if (k <= HOST_TASKS) {
+      current = last = i;
+      swapcontext(&kernel_ctx, &tasks[i].ctx);
+      current = -1;
+      if (tasks[i].state == TSK_FREE && tasks[i].stack) {
+        free(tasks[i].stack);
+        tasks[i].stack = NULL;
+      }
+      continue;
+    }
+
+    /* Everything waits, advance time to wake someone                         */
+    waiting = 0;
+    for (i = 0; i < HOST_TASKS; i++) {
+      waiting |= tasks[i].timed;
+    }
+    if (!waiting) {
+      return;
+    }
+    if (!Host_Tick(++ticks)) {
+      return;
+    }
+    for (i = 0; i < HOST_TASKS; i++) {
+      if (tasks[i].timed && (int32_t)(ticks - tasks[i].wake_tick) >= 0) {
+        task_ready(&tasks[i], OS_R_TMO);
+      }
+    }
+  }
+}
+
+OS_TID os_tsk_create (void (*task)(void), U8 priority) {
+  Host_Task *t;
+  int i;
+
+  (void)priority;                       /* Tasks only run when others wait    */
+
+  for (i = 0; i < HOST_TASKS && tasks[i].state != TSK_FREE; i++);
+  if (i == HOST_TASKS) {
+    return 0;
+  }
+  t = &tasks[i];
+  if (t->stack == NULL) {
+    t->stack = malloc(HOST_STACK);
+  }
+  t->entry    = task;
+  t->events   = 0;
+  t->interval = 0;
+  task_ready(t, OS_R_OK);
+
+  getcontext(&t->ctx);
+  t->ctx.uc_stack.ss_sp   = t->stack;
+  t->ctx.uc_stack.ss_size = HOST_STACK;
+  t->ctx.uc_link          = &kernel_ctx;
+  makecontext(&t->ctx, task_start, 0);
+  return i + 1;
+}
+
+void os_tsk_delete_self (void) {
+  tasks[current].state = TSK_FREE;
+  tasks[current].timed = 0;
+  task_switch();
+}
+
+void os_tsk_pass (void) {
+  task_switch();
+}
+
+OS_TID os_tsk_self (void) {
+  return current + 1;
+}
+
+OS_RESULT os_evt_wait_or (U16 wait_flags, U16 timeout) {
+  Host_Task *t = &tasks[current];
+
+  if (t->events & wait_flags) {
+    t->events &= ~wait_flags;
+    return OS_R_EVT;
+  }
+  if (timeout == 0) {
+    return OS_R_TMO;
+  }
+  t->state      = TSK_WAIT_EVT;
+  t->wait_flags = wait_flags;
+  t->timed      = (timeout != HOST_FOREVER);
+  t->wake_tick  = ticks + timeout;
+  return task_switch();
+}
+
+void os_evt_set (U16 event_flags, OS_TID task_id) {
+  Host_Task *t;
+
+  if (task_id == 0 || task_id > HOST_TASKS) {
+    return;
+  }
+  t = &tasks[task_id - 1];
+  t->events |= event_flags;
+  if (t->state == TSK_WAIT_EVT && (t->events & t->wait_flags)) {
+    t->events &= ~t->wait_flags;
+    task_ready(t, OS_R_EVT);
+  }
+}
+
+void isr_evt_set (U16 event_flags, OS_TID task_id) {
+  os_evt_set(event_flags, task_id);
+}
+
+void os_mut_init (OS_ID mutex) {
+  ((OS_MUT *)mutex)->owner = 0;
+  ((OS_MUT *)mutex)->count = 0;
+}
+
+OS_RESULT os_mut_wait (OS_ID mutex, U16 timeout) {
+  OS_MUT *m = (OS_MUT *)mutex;
+
+  /* Only a task that waits while holding one can keep it from another        */
+  while (m->owner != 0 && m->owner != os_tsk_self()) {
+    if (timeout == 0) {
+      return OS_R_TMO;
+    }
+    os_tsk_pass();
+  }
+  m->owner = os_tsk_self();
+  m->count++;
+  return OS_R_OK;
+}
+
+OS_RESULT os_mut_release (OS_ID mutex) {
+  OS_MUT *m = (OS_MUT *)mutex;
+
+  if (m->owner != os_tsk_self()) {
+    return 0xFF;
+  }
+  if (--m->count == 0) {
+    m->owner = 0;
+  }
+  return OS_R_OK;
+}
+
+void os_dly_wait (U16 delay_time) {
+  Host_Task *t = &tasks[current];
+
+  t->state     = TSK_WAIT_DLY;
+  t->timed     = 1;
+  t->wake_tick = ticks + delay_time;
+  task_switch();
+}
+
+void os_itv_set (U16 interval_time) {
+  tasks[current].interval = interval_time;
+  tasks[current].next_itv = ticks + interval_time;
+}
+
+void os_itv_wait (void) {
+  Host_Task *t = &tasks[current];
+  uint32_t   wake = t->next_itv;
+
+  t->next_itv += t->interval;
+  if ((int32_t)(ticks - wake) >= 0) {
+    return;
+  }
+  t->state     = TSK_WAIT_DLY;
+  t->timed     = 1;
+  t->wake_tick = wake;
+  task_switch();
+}
+
+/*******************************************************************************
+* Virtual ticks since os_sys_init                                              *
+*******************************************************************************/
+
+uint32_t Host_Ticks (void) {
+  return ticks;
+}
+
+/******************************************************************************/
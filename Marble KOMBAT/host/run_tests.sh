@@ -0,0 +1,33 @@
+#!/bin/sh
+# run_tests.sh: Host tests, on Linux
+#   Builds each test program of the host directory into a scratch directory
+#   and runs it. Every test prints a line per check and exits non-zero if
+#   any check failed. Tests that play the game include main.c themselves,
+#   and may add compile and link flags ahead of their sources.
+#
+#   Run from the project directory:
+#     sh host/run_tests.sh
+#   CC and CFLAGS choose the compiler and its flags.
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2 -Wall -Wextra}
+OUT=$(mktemp -d)
+failed=0
+
+# name: sources
+while read -r name sources; do
+  echo "== $name"
+  if ! $CC $CFLAGS -Ihost $sources -o "$OUT/$name"; then
+    echo "$name: build failed"
+    failed=1
+    continue
+  fi
+  "$OUT/$name" || failed=1
+done <<LIST
+glcd_test GLCD_SPI_LPC1700.c host/lpc17xx_host.c host/glcd_test.c
+display_list_test -Wl,--wrap=GLCD_List_Replay fixed.c track.c GLCD_List.c replay.c GLCD_SPI_LPC1700.c host/hal_host.c host/rtx_host.c host/lpc17xx_host.c host/display_list_test.c
+frame_image_test -DMAX_BULLETS=4 fixed.c track.c GLCD_List.c replay.c GLCD_SPI_LPC1700.c host/hal_host.c host/rtx_host.c host/lpc17xx_host.c host/frame_image_test.c
+LIST
+
+rm -rf "$OUT"
+exit $failed
@@ -0,0 +1,183 @@
+/******************************************************************************/
+/* spi_cost.c: SPI traffic of the GLCD driver, measured on the Linux host     */
+/*   Runs GLCD_SPI_LPC1700.c against the register mock in lpc17xx.h and       */
+/*   prints what each call puts on the bus, as CSV: bytes shifted out, chip   */
+/*   select assertions, register writes, and the time the bytes take at the   */
+/*   SSP1 clock GLCD_Init programs. The time is wire time only, frames back   */
+/*   to back.                                                                 */
+/*                                                                            */
+/*   The frame rows go through the game's own renderer: a train built as the  */
+/*   game logic does is laid on the serpentine track of track_bench.h, its    */
+/*   snapshot published, and Render_Frame draws it with the cannon and score  */
+/*   through the display list. Each row is the frame after one where the      */
+/*   train, or the cannon, was a pixel, or a degree, behind. The trains grow  */
+/*   from the track start, so a longer one covers more of the screen.         */
+/*                                                                            */
+/*   Build from the project directory, as the host build with this file in    */
+/*   place of main.c:                                                         */
+/*     cc -O2 -Wall -Wextra -Ihost -DMAX_TRAIN=200 fixed.c track.c            */
+/*        GLCD_List.c replay.c GLCD_SPI_LPC1700.c host/hal_host.c             */
+/*        host/rtx_host.c host/lpc17xx_host.c host/spi_cost.c -o spi_cost     */
+/******************************************************************************/
+
+#define main Game_Main                  /* The game's own entry is not used   */
+#include "../main.c"
+#undef main
+
+#include <lpc17xx.h>
+#include "track_bench.h"
+
+#define CCLK            100000000       /* Core clock, as on the board        */
+#define COST_SEED       0xACE1
+
+/*---------------------------- Global variables ------------------------------*/
+
+static unsigned int   ssp_hz;
+static int            frame_cur;        /* Sprite list of the last frame      */
+static char           frame_score[SCORE_DIGITS + 1]; /* Score on screen       */
+
+/************************ Local auxiliary functions ***************************/
+
+/*******************************************************************************
+* Print the traffic of the calls made since the last row and start a new one   *
+*   Parameter:    call:   row name                                             *
+*                 pixels: pixels the calls drew                                *
+*******************************************************************************/
+
+static void row (const char *call, unsigned int pixels) {
+
+  GLCD_Wait();
+  Mock_Sync();
+  printf("%s,%u,%u,%u,%u,%.4f\n", call, pixels, Mock_Count.bytes, Mock_Count.selects,
+         Mock_Count.writes, Mock_Count.bytes * 8000.0 / ssp_hz);
+  Mock_Reset();
+}
+
+/*******************************************************************************
+* Start a measurement from a full screen window, so no window write is elided  *
+*******************************************************************************/
+
+static void start (void) {
+
+  GLCD_WindowMax();
+  GLCD_Wait();
+  Mock_Reset();
+}
+
+/*******************************************************************************
+* Lay a train of one segment on the bench track from its start, as            *
+* Train_Start does                                                             *
+*   Parameter:    num:    marbles                                              *
+*                 offset: distance of the rearmost marble (px)                 *
+*******************************************************************************/
+
+static void lay_train (int num, int offset) {
+  Train *t = &trains[0];
+  int    i;
+
+  t->track        = &track_serpentine;
+  t->length       = num;
+  t->num_segments = (num > 0);
+  t->segment[0].first  = 0;
+  t->segment[0].offset = t->segment[0].prev_offset = TO_FIXED(offset);
+  for (i = 0; i < num; i++) {
+    t->colour[i] = Generate_Colour();
+  }
+  for (i = 0; i < num; i = Train_Rescan_Run(t, i) + 1);
+}
+
+/*******************************************************************************
+* Publish the game state and draw it as LCD_Display does                       *
+*   Return:               pixels the frame pushed                              *
+*******************************************************************************/
+
+static unsigned int draw_frame (void) {
+
+  Publish_Snapshot(SIM_ALPHA_ONE);
+  frame_cur ^= 1;
+  Render_Frame(Acquire_Snapshot(), frame_cur, frame_score);
+  return frame_pixels;
+}
+
+/*******************************************************************************
+* Start frames from a blank screen with nothing on it                          *
+*******************************************************************************/
+
+static void blank_screen (void) {
+
+  GLCD_Clear(BACKGROUND_COLOUR);
+  num_sprites[frame_cur] = 0;
+  frame_score[0] = '\0';
+}
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Measure the calls and print one row each                                     *
+*******************************************************************************/
+
+int main (void) {
+  static const int    lengths[] = { 7, 50, 200 };
+  static const int    sizes[][2] = { { 4, 4 }, { 16, 16 }, { 17, 16 }, { 16, 32 },
+                                     { 48, 24 }, { 240, 16 } };
+  static const unsigned int pclk_div[4] = { 4, 1, 2, 8 };
+  char         name[32];
+  unsigned int i;
+
+  Mock_Reset();
+  GLCD_Init();
+  GLCD_SetWaitHook(Mock_Interrupts);
+  ssp_hz = CCLK / pclk_div[(Mock_SC.PCLKSEL0 >> 20) & 3] /
+           (Mock_SSP1()->CPSR * ((Mock_SSP1()->CR0 >> 8) + 1));
+
+  printf("# ssp_hz=%u, MAX_TRAIN=%d\n", ssp_hz, MAX_TRAIN);
+  printf("call,pixels,bytes,selects,writes,ms\n");
+  row("GLCD_Init", 0);
+
+  start();
+  GLCD_Clear(0x0000);
+  row("GLCD_Clear", WIDTH * HEIGHT);
+
+  for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    start();
+    GLCD_Bitmap(100, 100, sizes[i][0], sizes[i][1], (unsigned char *)strip_bmp);
+    sprintf(name, "GLCD_Bitmap %dx%d", sizes[i][0], sizes[i][1]);
+    row(name, sizes[i][0] * sizes[i][1]);
+  }
+
+  start();
+  GLCD_DisplayString(1, 5, 0, (unsigned char *)"0123456789");
+  row("GLCD_DisplayString 6x8 10 chars", 10 * 6 * 8);
+  start();
+  GLCD_DisplayString(1, 5, 1, (unsigned char *)"0123456789");
+  row("GLCD_DisplayString 16x24 10 chars", 10 * 16 * 24);
+
+  /* Game frames, as the game logic sets them up                              */
+  state = GAME_ON;
+  seed  = COST_SEED;
+  chambered_colour = Generate_Colour();
+  spare_colour     = Generate_Colour();
+  snprintf(score_str, sizeof(score_str), "%03u", (unsigned int)score);
+
+  blank_screen();
+  lay_train(0, 0);
+  cannon_angle = 0;
+  draw_frame();
+  cannon_angle = 1;
+  start();
+  row("cannon turned 1 deg", draw_frame());
+
+  for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    blank_screen();
+    lay_train(lengths[i], MARBLE_DIAMETER);
+    draw_frame();
+    Train_Save_Positions(&trains[0]);
+    trains[0].segment[0].offset += TO_FIXED(1);
+    start();
+    sprintf(name, "frame train %d", lengths[i]);
+    row(name, draw_frame());
+  }
+  return 0;
+}
+
+/******************************************************************************/
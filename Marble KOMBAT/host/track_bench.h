@@ -0,0 +1,201 @@
+/******************************************************************************/
+/* track_bench.h: Tracks for the host measurements                            */
+/*   Longer than the game's, so long trains fit on screen. Generated by       */
+/*   host/track_gen.py --bench, edit the tracks there and rerun it. Included  */
+/*   by a single host program, so the tables are static.                      */
+/******************************************************************************/
+
+#ifndef _TRACK_BENCH_H
+#define _TRACK_BENCH_H
+
+#include "../track.h"
+
+/* Back and forth across the whole screen, one pass every 24 px, vertices:
+ *   (12, 12) to (228, 12), down to (228, 36), back to (12, 36) and so on,
+ *   13 passes down to y = 300 */
+
+static const short serpentine_sample[775][2] = {
+  {  192,   192}, {  256,   192}, {  320,   192}, {  384,   192}, {  448,   192},
+  {  512,   192}, {  576,   192}, {  640,   192}, {  704,   192}, {  768,   192},
+  {  832,   192}, {  896,   192}, {  960,   192}, { 1024,   192}, { 1088,   192},
+  { 1152,   192}, { 1216,   192}, { 1280,   192}, { 1344,   192}, { 1408,   192},
+  { 1472,   192}, { 1536,   192}, { 1600,   192}, { 1664,   192}, { 1728,   192},
+  { 1792,   192}, { 1856,   192}, { 1920,   192}, { 1984,   192}, { 2048,   192},
+  { 2112,   192}, { 2176,   192}, { 2240,   192}, { 2304,   192}, { 2368,   192},
+  { 2432,   192}, { 2496,   192}, { 2560,   192}, { 2624,   192}, { 2688,   192},
+  { 2752,   192}, { 2816,   192}, { 2880,   192}, { 2944,   192}, { 3008,   192},
+  { 3072,   192}, { 3136,   192}, { 3200,   192}, { 3264,   192}, { 3328,   192},
+  { 3392,   192}, { 3456,   192}, { 3520,   192}, { 3584,   192}, { 3648,   192},
+  { 3648,   256}, { 3648,   320}, { 3648,   384}, { 3648,   448}, { 3648,   512},
+  { 3648,   576}, { 3584,   576}, { 3520,   576}, { 3456,   576}, { 3392,   576},
+  { 3328,   576}, { 3264,   576}, { 3200,   576}, { 3136,   576}, { 3072,   576},
+  { 3008,   576}, { 2944,   576}, { 2880,   576}, { 2816,   576}, { 2752,   576},
+  { 2688,   576}, { 2624,   576}, { 2560,   576}, { 2496,   576}, { 2432,   576},
+  { 2368,   576}, { 2304,   576}, { 2240,   576}, { 2176,   576}, { 2112,   576},
+  { 2048,   576}, { 1984,   576}, { 1920,   576}, { 1856,   576}, { 1792,   576},
+  { 1728,   576}, { 1664,   576}, { 1600,   576}, { 1536,   576}, { 1472,   576},
+  { 1408,   576}, { 1344,   576}, { 1280,   576}, { 1216,   576}, { 1152,   576},
+  { 1088,   576}, { 1024,   576}, {  960,   576}, {  896,   576}, {  832,   576},
+  {  768,   576}, {  704,   576}, {  640,   576}, {  576,   576}, {  512,   576},
+  {  448,   576}, {  384,   576}, {  320,   576}, {  256,   576}, {  192,   576},
+  {  192,   640}, {  192,   704}, {  192,   768}, {  192,   832}, {  192,   896},
+  {  192,   960}, {  256,   960}, {  320,   960}, {  384,   960}, {  448,   960},
+  {  512,   960}, {  576,   960}, {  640,   960}, {  704,   960}, {  768,   960},
+  {  832,   960}, {  896,   960}, {  960,   960}, { 1024,   960}, { 1088,   960},
+  { 1152,   960}, { 1216,   960}, { 1280,   960}, { 1344,   960}, { 1408,   960},
+  { 1472,   960}, { 1536,   960}, { 1600,   960}, { 1664,   960}, { 1728,   960},
+  { 1792,   960}, { 1856,   960}, { 1920,   960}, { 1984,   960}, { 2048,   960},
+  { 2112,   960}, { 2176,   960}, { 2240,   960}, { 2304,   960}, { 2368,   960},
+  { 2432,   960}, { 2496,   960}, { 2560,   960}, { 2624,   960}, { 2688,   960},
+  { 2752,   960}, { 2816,   960}, { 2880,   960}, { 2944,   960}, { 3008,   960},
+  { 3072,   960}, { 3136,   960}, { 3200,   960}, { 3264,   960}, { 3328,   960},
+  { 3392,   960}, { 3456,   960}, { 3520,   960}, { 3584,   960}, { 3648,   960},
+  { 3648,  1024}, { 3648,  1088}, { 3648,  1152}, { 3648,  1216}, { 3648,  1280},
+  { 3648,  1344}, { 3584,  1344}, { 3520,  1344}, { 3456,  1344}, { 3392,  1344},
+  { 3328,  1344}, { 3264,  1344}, { 3200,  1344}, { 3136,  1344}, { 3072,  1344},
+  { 3008,  1344}, { 2944,  1344}, { 2880,  1344}, { 2816,  1344}, { 2752,  1344},
+  { 2688,  1344}, { 2624,  1344}, { 2560,  1344}, { 2496,  1344}, { 2432,  1344},
+  { 2368,  1344}, { 2304,  1344}, { 2240,  1344}, { 2176,  1344}, { 2112,  1344},
+  { 2048,  1344}, { 1984,  1344}, { 1920,  1344}, { 1856,  1344}, { 1792,  1344},
+  { 1728,  1344}, { 1664,  1344}, { 1600,  1344}, { 1536,  1344}, { 1472,  1344},
+  { 1408,  1344}, { 1344,  1344}, { 1280,  1344}, { 1216,  1344}, { 1152,  1344},
+  { 1088,  1344}, { 1024,  1344}, {  960,  1344}, {  896,  1344}, {  832,  1344},
+  {  768,  1344}, {  704,  1344}, {  640,  1344}, {  576,  1344}, {  512,  1344},
+  {  448,  1344}, {  384,  1344}, {  320,  1344}, {  256,  1344}, {  192,  1344},
+  {  192,  1408}, {  192,  1472}, {  192,  1536}, {  192,  1600}, {  192,  1664},
+  {  192,  1728}, {  256,  1728}, {  320,  1728}, {  384,  1728}, {  448,  1728},
+  {  512,  1728}, {  576,  1728}, {  640,  1728}, {  704,  1728}, {  768,  1728},
+  {  832,  1728}, {  896,  1728}, {  960,  1728}, { 1024,  1728}, { 1088,  1728},
+  { 1152,  1728}, { 1216,  1728}, { 1280,  1728}, { 1344,  1728}, { 1408,  1728},
+  { 1472,  1728}, { 1536,  1728}, { 1600,  1728}, { 1664,  1728}, { 1728,  1728},
+  { 1792,  1728}, { 1856,  1728}, { 1920,  1728}, { 1984,  1728}, { 2048,  1728},
+  { 2112,  1728}, { 2176,  1728}, { 2240,  1728}, { 2304,  1728}, { 2368,  1728},
+  { 2432,  1728}, { 2496,  1728}, { 2560,  1728}, { 2624,  1728}, { 2688,  1728},
+  { 2752,  1728}, { 2816,  1728}, { 2880,  1728}, { 2944,  1728}, { 3008,  1728},
+  { 3072,  1728}, { 3136,  1728}, { 3200,  1728}, { 3264,  1728}, { 3328,  1728},
+  { 3392,  1728}, { 3456,  1728}, { 3520,  1728}, { 3584,  1728}, { 3648,  1728},
+  { 3648,  1792}, { 3648,  1856}, { 3648,  1920}, { 3648,  1984}, { 3648,  2048},
+  { 3648,  2112}, { 3584,  2112}, { 3520,  2112}, { 3456,  2112}, { 3392,  2112},
+  { 3328,  2112}, { 3264,  2112}, { 3200,  2112}, { 3136,  2112}, { 3072,  2112},
+  { 3008,  2112}, { 2944,  2112}, { 2880,  2112}, { 2816,  2112}, { 2752,  2112},
+  { 2688,  2112}, { 2624,  2112}, { 2560,  2112}, { 2496,  2112}, { 2432,  2112},
+  { 2368,  2112}, { 2304,  2112}, { 2240,  2112}, { 2176,  2112}, { 2112,  2112},
+  { 2048,  2112}, { 1984,  2112}, { 1920,  2112}, { 1856,  2112}, { 1792,  2112},
+  { 1728,  2112}, { 1664,  2112}, { 1600,  2112}, { 1536,  2112}, { 1472,  2112},
+  { 1408,  2112}, { 1344,  2112}, { 1280,  2112}, { 1216,  2112}, { 1152,  2112},
+  { 1088,  2112}, { 1024,  2112}, {  960,  2112}, {  896,  2112}, {  832,  2112},
+  {  768,  2112}, {  704,  2112}, {  640,  2112}, {  576,  2112}, {  512,  2112},
+  {  448,  2112}, {  384,  2112}, {  320,  2112}, {  256,  2112}, {  192,  2112},
+  {  192,  2176}, {  192,  2240}, {  192,  2304}, {  192,  2368}, {  192,  2432},
+  {  192,  2496}, {  256,  2496}, {  320,  2496}, {  384,  2496}, {  448,  2496},
+  {  512,  2496}, {  576,  2496}, {  640,  2496}, {  704,  2496}, {  768,  2496},
+  {  832,  2496}, {  896,  2496}, {  960,  2496}, { 1024,  2496}, { 1088,  2496},
+  { 1152,  2496}, { 1216,  2496}, { 1280,  2496}, { 1344,  2496}, { 1408,  2496},
+  { 1472,  2496}, { 1536,  2496}, { 1600,  2496}, { 1664,  2496}, { 1728,  2496},
+  { 1792,  2496}, { 1856,  2496}, { 1920,  2496}, { 1984,  2496}, { 2048,  2496},
+  { 2112,  2496}, { 2176,  2496}, { 2240,  2496}, { 2304,  2496}, { 2368,  2496},
+  { 2432,  2496}, { 2496,  2496}, { 2560,  2496}, { 2624,  2496}, { 2688,  2496},
+  { 2752,  2496}, { 2816,  2496}, { 2880,  2496}, { 2944,  2496}, { 3008,  2496},
+  { 3072,  2496}, { 3136,  2496}, { 3200,  2496}, { 3264,  2496}, { 3328,  2496},
+  { 3392,  2496}, { 3456,  2496}, { 3520,  2496}, { 3584,  2496}, { 3648,  2496},
+  { 3648,  2560}, { 3648,  2624}, { 3648,  2688}, { 3648,  2752}, { 3648,  2816},
+  { 3648,  2880}, { 3584,  2880}, { 3520,  2880}, { 3456,  2880}, { 3392,  2880},
+  { 3328,  2880}, { 3264,  2880}, { 3200,  2880}, { 3136,  2880}, { 3072,  2880},
+  { 3008,  2880}, { 2944,  2880}, { 2880,  2880}, { 2816,  2880}, { 2752,  2880},
+  { 2688,  2880}, { 2624,  2880}, { 2560,  2880}, { 2496,  2880}, { 2432,  2880},
+  { 2368,  2880}, { 2304,  2880}, { 2240,  2880}, { 2176,  2880}, { 2112,  2880},
+  { 2048,  2880}, { 1984,  2880}, { 1920,  2880}, { 1856,  2880}, { 1792,  2880},
+  { 1728,  2880}, { 1664,  2880}, { 1600,  2880}, { 1536,  2880}, { 1472,  2880},
+  { 1408,  2880}, { 1344,  2880}, { 1280,  2880}, { 1216,  2880}, { 1152,  2880},
+  { 1088,  2880}, { 1024,  2880}, {  960,  2880}, {  896,  2880}, {  832,  2880},
+  {  768,  2880}, {  704,  2880}, {  640,  2880}, {  576,  2880}, {  512,  2880},
+  {  448,  2880}, {  384,  2880}, {  320,  2880}, {  256,  2880}, {  192,  2880},
+  {  192,  2944}, {  192,  3008}, {  192,  3072}, {  192,  3136}, {  192,  3200},
+  {  192,  3264}, {  256,  3264}, {  320,  3264}, {  384,  3264}, {  448,  3264},
+  {  512,  3264}, {  576,  3264}, {  640,  3264}, {  704,  3264}, {  768,  3264},
+  {  832,  3264}, {  896,  3264}, {  960,  3264}, { 1024,  3264}, { 1088,  3264},
+  { 1152,  3264}, { 1216,  3264}, { 1280,  3264}, { 1344,  3264}, { 1408,  3264},
+  { 1472,  3264}, { 1536,  3264}, { 1600,  3264}, { 1664,  3264}, { 1728,  3264},
+  { 1792,  3264}, { 1856,  3264}, { 1920,  3264}, { 1984,  3264}, { 2048,  3264},
+  { 2112,  3264}, { 2176,  3264}, { 2240,  3264}, { 2304,  3264}, { 2368,  3264},
+  { 2432,  3264}, { 2496,  3264}, { 2560,  3264}, { 2624,  3264}, { 2688,  3264},
+  { 2752,  3264}, { 2816,  3264}, { 2880,  3264}, { 2944,  3264}, { 3008,  3264},
+  { 3072,  3264}, { 3136,  3264}, { 3200,  3264}, { 3264,  3264}, { 3328,  3264},
+  { 3392,  3264}, { 3456,  3264}, { 3520,  3264}, { 3584,  3264}, { 3648,  3264},
+  { 3648,  3328}, { 3648,  3392}, { 3648,  3456}, { 3648,  3520}, { 3648,  3584},
+  { 3648,  3648}, { 3584,  3648}, { 3520,  3648}, { 3456,  3648}, { 3392,  3648},
+  { 3328,  3648}, { 3264,  3648}, { 3200,  3648}, { 3136,  3648}, { 3072,  3648},
+  { 3008,  3648}, { 2944,  3648}, { 2880,  3648}, { 2816,  3648}, { 2752,  3648},
+  { 2688,  3648}, { 2624,  3648}, { 2560,  3648}, { 2496,  3648}, { 2432,  3648},
+  { 2368,  3648}, { 2304,  3648}, { 2240,  3648}, { 2176,  3648}, { 2112,  3648},
+  { 2048,  3648}, { 1984,  3648}, { 1920,  3648}, { 1856,  3648}, { 1792,  3648},
+  { 1728,  3648}, { 1664,  3648}, { 1600,  3648}, { 1536,  3648}, { 1472,  3648},
+  { 1408,  3648}, { 1344,  3648}, { 1280,  3648}, { 1216,  3648}, { 1152,  3648},
+  { 1088,  3648}, { 1024,  3648}, {  960,  3648}, {  896,  3648}, {  832,  3648},
+  {  768,  3648}, {  704,  3648}, {  640,  3648}, {  576,  3648}, {  512,  3648},
+  {  448,  3648}, {  384,  3648}, {  320,  3648}, {  256,  3648}, {  192,  3648},
+  {  192,  3712}, {  192,  3776}, {  192,  3840}, {  192,  3904}, {  192,  3968},
+  {  192,  4032}, {  256,  4032}, {  320,  4032}, {  384,  4032}, {  448,  4032},
+  {  512,  4032}, {  576,  4032}, {  640,  4032}, {  704,  4032}, {  768,  4032},
+  {  832,  4032}, {  896,  4032}, {  960,  4032}, { 1024,  4032}, { 1088,  4032},
+  { 1152,  4032}, { 1216,  4032}, { 1280,  4032}, { 1344,  4032}, { 1408,  4032},
+  { 1472,  4032}, { 1536,  4032}, { 1600,  4032}, { 1664,  4032}, { 1728,  4032},
+  { 1792,  4032}, { 1856,  4032}, { 1920,  4032}, { 1984,  4032}, { 2048,  4032},
+  { 2112,  4032}, { 2176,  4032}, { 2240,  4032}, { 2304,  4032}, { 2368,  4032},
+  { 2432,  4032}, { 2496,  4032}, { 2560,  4032}, { 2624,  4032}, { 2688,  4032},
+  { 2752,  4032}, { 2816,  4032}, { 2880,  4032}, { 2944,  4032}, { 3008,  4032},
+  { 3072,  4032}, { 3136,  4032}, { 3200,  4032}, { 3264,  4032}, { 3328,  4032},
+  { 3392,  4032}, { 3456,  4032}, { 3520,  4032}, { 3584,  4032}, { 3648,  4032},
+  { 3648,  4096}, { 3648,  4160}, { 3648,  4224}, { 3648,  4288}, { 3648,  4352},
+  { 3648,  4416}, { 3584,  4416}, { 3520,  4416}, { 3456,  4416}, { 3392,  4416},
+  { 3328,  4416}, { 3264,  4416}, { 3200,  4416}, { 3136,  4416}, { 3072,  4416},
+  { 3008,  4416}, { 2944,  4416}, { 2880,  4416}, { 2816,  4416}, { 2752,  4416},
+  { 2688,  4416}, { 2624,  4416}, { 2560,  4416}, { 2496,  4416}, { 2432,  4416},
+  { 2368,  4416}, { 2304,  4416}, { 2240,  4416}, { 2176,  4416}, { 2112,  4416},
+  { 2048,  4416}, { 1984,  4416}, { 1920,  4416}, { 1856,  4416}, { 1792,  4416},
+  { 1728,  4416}, { 1664,  4416}, { 1600,  4416}, { 1536,  4416}, { 1472,  4416},
+  { 1408,  4416}, { 1344,  4416}, { 1280,  4416}, { 1216,  4416}, { 1152,  4416},
+  { 1088,  4416}, { 1024,  4416}, {  960,  4416}, {  896,  4416}, {  832,  4416},
+  {  768,  4416}, {  704,  4416}, {  640,  4416}, {  576,  4416}, {  512,  4416},
+  {  448,  4416}, {  384,  4416}, {  320,  4416}, {  256,  4416}, {  192,  4416},
+  {  192,  4480}, {  192,  4544}, {  192,  4608}, {  192,  4672}, {  192,  4736},
+  {  192,  4800}, {  256,  4800}, {  320,  4800}, {  384,  4800}, {  448,  4800},
+  {  512,  4800}, {  576,  4800}, {  640,  4800}, {  704,  4800}, {  768,  4800},
+  {  832,  4800}, {  896,  4800}, {  960,  4800}, { 1024,  4800}, { 1088,  4800},
+  { 1152,  4800}, { 1216,  4800}, { 1280,  4800}, { 1344,  4800}, { 1408,  4800},
+  { 1472,  4800}, { 1536,  4800}, { 1600,  4800}, { 1664,  4800}, { 1728,  4800},
+  { 1792,  4800}, { 1856,  4800}, { 1920,  4800}, { 1984,  4800}, { 2048,  4800},
+  { 2112,  4800}, { 2176,  4800}, { 2240,  4800}, { 2304,  4800}, { 2368,  4800},
+  { 2432,  4800}, { 2496,  4800}, { 2560,  4800}, { 2624,  4800}, { 2688,  4800},
+  { 2752,  4800}, { 2816,  4800}, { 2880,  4800}, { 2944,  4800}, { 3008,  4800},
+  { 3072,  4800}, { 3136,  4800}, { 3200,  4800}, { 3264,  4800}, { 3328,  4800},
+  { 3392,  4800}, { 3456,  4800}, { 3520,  4800}, { 3584,  4800}, { 3648,  4800}
+};
+
+static const short serpentine_cell[TRACK_CELLS_Y * TRACK_CELLS_X][2] = {
+  {   0,  476}, {   0,  456}, {  28,  424}, {  60,  392},
+  {  92,  360}, { 124,  328}, { 156,  296}, { 188,  264},
+  {   0,  940}, {  16,  920}, {  48,  888}, {  80,  856},
+  { 112,  824}, { 144,  792}, { 176,  760}, { 208,  728},
+  { 460, 1000}, { 480, 1032}, { 512, 1064}, { 544, 1096},
+  { 576, 1128}, { 608, 1160}, { 640, 1184}, { 672, 1188},
+  { 896, 1436}, { 864, 1416}, { 832, 1384}, { 800, 1352},
+  { 768, 1320}, { 736, 1288}, { 712, 1256}, { 708, 1224},
+  { 956, 1900}, { 976, 1880}, {1008, 1848}, {1040, 1816},
+  {1072, 1784}, {1104, 1752}, {1136, 1720}, {1168, 1688},
+  {1420, 1960}, {1440, 1992}, {1472, 2024}, {1504, 2056},
+  {1536, 2088}, {1568, 2120}, {1600, 2144}, {1632, 2148},
+  {1856, 2396}, {1824, 2376}, {1792, 2344}, {1760, 2312},
+  {1728, 2280}, {1696, 2248}, {1672, 2216}, {1668, 2184},
+  {1916, 2860}, {1936, 2840}, {1968, 2808}, {2000, 2776},
+  {2032, 2744}, {2064, 2712}, {2096, 2680}, {2128, 2648},
+  {2380, 2920}, {2400, 2952}, {2432, 2984}, {2464, 3016},
+  {2496, 3048}, {2528, 3080}, {2560, 3100}, {2592, 3100},
+  {2816, 2924}, {2784, 2956}, {2752, 2988}, {2720, 3020},
+  {2688, 3052}, {2656, 3084}, {2632, 3100}, {2628, 3100}
+};
+
+/* 3096.00 px long */
+static const Track track_serpentine = { serpentine_sample, 775, serpentine_cell, 202899456 };
+
+#endif /* _TRACK_BENCH_H */
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+# track_gen.py: Generator of the track tables in track.c
+#   Each track is a polyline. It is resampled every TRACK_SAMPLE px of arc
+#   length to positions in 1/(1 << TRACK_FRAC) px, and every TRACK_CELL px
+#   cell of the screen gets the range of distances whose samples pass within
+#   TRACK_REACH px of it, widened by a sample at each end. The constants
+#   must match track.h.
+#
+#   Run from the project directory:
+#     python3 host/track_gen.py            print the tables
+#     python3 host/track_gen.py track.c    rewrite the tables in place,
+#                                          between the Global variables and
+#                                          Exported functions banners
+#     python3 host/track_gen.py --bench > host/track_bench.h
+#                                          write the longer tracks the host
+#                                          measurements lay trains on
+
+import math
+import sys
+
+TRACK_SAMPLE = 4
+TRACK_FRAC = 4
+TRACK_CELL = 32
+TRACK_CELLS_X = 8
+TRACK_CELLS_Y = 10
+TRACK_REACH = 16
+
+BEGIN = "/*---------------------------- Global variables ------------------------------*/\n"
+END = "/************************ Exported functions **********************************/\n"
+
+
+def spiral():
+    """Two turns in to (155, 165), every 15 degrees clockwise from the top"""
+    cx, cy, turns = 155, 165, 2
+    n = 24 * turns
+    pts = [(155, 0), (155, 90)]
+    for k in range(1, n + 1):
+        a = -math.pi / 2 + 2 * math.pi * k / 24
+        r = 75 - 50 * k / n
+        pts.append((cx + r * math.cos(a), cy + r * math.sin(a)))
+    return pts
+
+
+def serpentine():
+    """Back and forth across the screen every 24 px, from the top left"""
+    pts = []
+    for k, y in enumerate(range(12, 320 - 12 + 1, 24)):
+        pts += [(12, y), (228, y)] if k % 2 == 0 else [(228, y), (12, y)]
+    return pts
+
+
+# name, description, vertices, vertex comment when the list is too long
+TRACKS = [
+    ("column", "Straight down the right of the screen",
+     [(200, 0), (200, 320)], None),
+    ("zigzag", "Zig-zag across the right two thirds of the screen",
+     [(200, 0), (200, 40), (110, 100), (210, 160), (110, 220), (200, 280),
+      (200, 320)], None),
+    ("spiral", "Two turns spiralling in to the centre of the right of the screen",
+     spiral(),
+     ["(155, 0), (155, 90), then every 15 degrees clockwise from the top around",
+      "(155, 165) with the radius shrinking from 75 to 25 over the two turns"]),
+]
+
+# Host only, long enough for a train of 200 marbles
+BENCH_TRACKS = [
+    ("serpentine", "Back and forth across the whole screen, one pass every 24 px",
+     serpentine(),
+     ["(12, 12) to (228, 12), down to (228, 36), back to (12, 36) and so on,",
+      "13 passes down to y = 300"]),
+]
+
+BENCH_HEAD = """/******************************************************************************/
+/* track_bench.h: Tracks for the host measurements                            */
+/*   Longer than the game's, so long trains fit on screen. Generated by       */
+/*   host/track_gen.py --bench, edit the tracks there and rerun it. Included  */
+/*   by a single host program, so the tables are static.                      */
+/******************************************************************************/
+
+#ifndef _TRACK_BENCH_H
+#define _TRACK_BENCH_H
+
+#include "../track.h"
+"""
+
+BENCH_TAIL = """
+#endif /* _TRACK_BENCH_H */
+"""
+
+
+def resample(pts):
+    """Points every TRACK_SAMPLE px along the polyline and its length"""
+    segs, total = [], 0.0
+    for a, b in zip(pts, pts[1:]):
+        length = math.dist(a, b)
+        segs.append((a, b, total, length))
+        total += length
+
+    out = []
+    for i in range(math.ceil(total / TRACK_SAMPLE) + 1):
+        d = min(i * TRACK_SAMPLE, total)
+        for a, b, start, length in segs:
+            if d <= start + length or (a, b) == segs[-1][:2]:
+                t = (d - start) / length if length else 0
+                t = max(0, min(1, t))
+                out.append((a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t))
+                break
+    return out, total
+
+
+def cells(samples):
+    """Distance range near each cell in px, empty cells as (0, -1)"""
+    out = []
+    for cy in range(TRACK_CELLS_Y):
+        for cx in range(TRACK_CELLS_X):
+            x0, y0 = cx * TRACK_CELL, cy * TRACK_CELL
+            x1, y1 = x0 + TRACK_CELL, y0 + TRACK_CELL
+            near = []
+            for i, (x, y) in enumerate(samples):
+                dx = max(x0 - x, 0, x - x1)
+                dy = max(y0 - y, 0, y - y1)
+                if math.hypot(dx, dy) <= TRACK_REACH + TRACK_SAMPLE:
+                    near.append(i * TRACK_SAMPLE)
+            if near:
+                out.append((max(min(near) - TRACK_SAMPLE, 0), max(near) + TRACK_SAMPLE))
+            else:
+                out.append((0, -1))
+    return out
+
+
+def rows(values, per):
+    return ",\n".join("  " + ", ".join(values[i:i + per])
+                      for i in range(0, len(values), per))
+
+
+def vertex_lines(pts):
+    """The vertex list wrapped to fit a comment"""
+    lines, cur = [], ""
+    for x, y in pts:
+        v = "(%g, %g)" % (round(x, 1), round(y, 1))
+        if cur and len(cur) + len(v) + 2 > 70:
+            lines.append(cur + ",")
+            cur = v
+        else:
+            cur += (", " if cur else "") + v
+    return lines + [cur]
+
+
+def tracks(track_list, storage):
+    """Tables of each track, the Track itself with the given storage class"""
+    out = []
+    for name, desc, pts, note in track_list:
+        samples, total = resample(pts)
+        sv = ["{%5d, %5d}" % (round(x * (1 << TRACK_FRAC)), round(y * (1 << TRACK_FRAC)))
+              for x, y in samples]
+        cv = ["{%4d, %4d}" % c for c in cells(samples)]
+        out.append("\n/* %s, vertices:\n%s */\n\n" %
+                   (desc, "\n".join(" *   " + l for l in (note or vertex_lines(pts)))))
+        out.append("static const short %s_sample[%d][2] = {\n%s\n};\n\n" %
+                   (name, len(samples), rows(sv, 5)))
+        out.append("static const short %s_cell[TRACK_CELLS_Y * TRACK_CELLS_X][2] = {\n%s\n};\n\n" %
+                   (name, rows(cv, 4)))
+        out.append("/* %.2f px long */\n%sconst Track track_%s = { %s_sample, %d, %s_cell, %d };\n" %
+                   (total, storage, name, name, len(samples), name, round(total * 65536)))
+    return out
+
+
+def tables():
+    out = [BEGIN,
+           "\n/* Generated by host/track_gen.py, edit the tracks there and rerun it */\n"]
+    out += tracks(TRACKS, "")
+    out.append("\n" + END)
+    return "".join(out)
+
+
+def bench():
+    return "".join([BENCH_HEAD] + tracks(BENCH_TRACKS, "static ") + [BENCH_TAIL])
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        sys.stdout.write(tables())
+        sys.exit(0)
+    if sys.argv[1] == "--bench":
+        sys.stdout.write(bench())
+        sys.exit(0)
+    with open(sys.argv[1], newline="") as f:
+        src = f.read()
+    crlf = "\r\n" in src
+    src = src.replace("\r\n", "\n")
+    begin, end = src.index(BEGIN), src.index(END) + len(END)
+    src = src[:begin] + tables() + src[end:]
+    with open(sys.argv[1], "w", newline="") as f:
+        f.write(src.replace("\n", "\r\n") if crlf else src)
@@ -1,803 +1,1733 @@
-// MARBLE KOMBAT
-// Hashem Botma, Hsuan Ling Chen
-
-#include <lpc17xx.h>
-#include <stdio.h>
-#include <stdbool.h>
-#include <stdlib.h>
-#include <string.h>
-#include <rtl.h>
-#include <math.h>
-#include <time.h>
-#include "uart.h"
-#include "GLCD.h"
-#include "led.h"
-#include "timer.h"
-
-#define ever ;;
-
-// Macro Functions -----------------------------------------------------------------------------------------------------
-#define RADIANS(theta)  (theta * 3.141592654 / 180)     // Degrees to radians
-#define SQUARE(x)       ((x) * (x))                     // Squares a number
-
-// Typedefs ------------------------------------------------------------------------------------------------------------
-// Colour enum type for marbles
-typedef enum {
-    BLACK = 0x0000,
-    RED,
-    BLUE,
-    GREEN,
-    YELLOW,
-    MAGENTA,
-    WHITE = 0xFFFF,
-} Colour;
-
-// Game state enum type for starting and ending game
-typedef enum {
-    TITLE_SCREEN,
-    GAME_ON,
-    FATALITY,
-    YOU_DIED,
-} Game_State;
-
-// Marble struct type
-typedef struct Marble Marble;
-struct Marble {
-    float x;
-    float y;
-    Colour colour;
-    Marble *next; // For marble linked list usage
-};
-
-// Constants -----------------------------------------------------------------------------------------------------------
-#define NUM_STARTING_MARBLES    7               // Marbles in train at start
-#define MARBLE_DIAMETER         16
-#define TRAIN_SPEED             8               // Pixels per second
-#define BULLET_SPEED            125             // Pixels per second
-#define WINDOW_X                240             // Pixel width
-#define WINDOW_Y                320             // Pixel height
-
-#define BACKGROUND_COLOUR       BLACK           // For clearing screen and patching
-#define TEXT_COLOUR             WHITE
-#define CANNON_COLOUR           WHITE 
-#define CANNON_X                25              // X position of cannon
-#define CANNON_Y                WINDOW_Y / 2    // Y position of cannon
-
-// Global variables ----------------------------------------------------------------------------------------------------
-// Mutexes for data sharing
-OS_MUT mut_LED, mut_LCD, mut_pot, mut_joy;
-
-// Inputs
-Game_State state;
-uint32_t pot_position;
-
-// Global marbles
-Marble *train_root; // The root of the marble linked list
-Marble *bullet; // The projectile marble
-
-// Game logic
-bool shoot_marble, swap_marble, marble_airborne, bullet_collision;
-int cannon_angle;
-float firing_angle;
-Colour chambered_colour, spare_colour;
-
-// Score tracking
-uint32_t score, score_multiplier;
-
-// Random number generation
-uint16_t seed;
-unsigned bit;
-
-// Graphics
-bool clear_screen;
-float bullet_patch_x, bullet_patch_y;
-uint16_t marble_draw_bmp_pri[144];
-uint16_t marble_draw_bmp_sec[12];
-uint16_t marble_patch_bmp[96];
-
-// Text display
-char score_str[3], title_str[] = "MARBLE KOMBAT", inst_str[] = "PRESS BUTTON TO BEGIN", gg_win_str[] = "FATALITY!", gg_lose_str[] = "YOU DIED", gg_score_str[] = "SCORE: ";
-  
-// Functions -----------------------------------------------------------------------------------------------------------
-// Place the marble at a position x,y
-void Position_Marble(Marble *marble, float x, float y) {
-    marble->x = x;
-    marble->y = y;
-}
-
-// Move the marble by an amount x,y
-void Move_Marble(Marble* marble, float x, float y) {
-    marble->x += x;
-    marble->y += y;
-}
-
-// Obtain the primary colour code given a colour enum
-uint16_t Get_Primary_Hex(Colour named_colour) {
-    switch (named_colour) {
-        case WHITE: return 0xFFFF;
-        case RED: return 0xF800;
-        case BLUE: return 0x05DF;
-        case GREEN: return 0x5DA0;
-        case YELLOW: return 0xFE60;
-        case BLACK: return 0x0000;
-        default: return 0xD01F; // Should never get here
-    }
-}
-
-// Obtain the secondary colour code given a colour enum
-uint16_t Get_Secondary_Hex(Colour named_colour) {
-    switch (named_colour) {
-        case WHITE: return 0xBDF7;
-        case RED: return 0xFC10;
-        case BLUE: return 0x51DF;
-        case GREEN: return 0xA7E7;
-        case YELLOW: return 0xFD00;
-        case BLACK: return 0x0000;
-        default: return 0xD01F; // Should never get here
-    }
-}
-
-// Render the marble at its position
-void Draw_Marble(Marble *marble) {
-    int i;
-    unsigned int x = marble->x - 8;
-    unsigned int y = marble->y - 8;
-   
-    // Set the rendering bitmaps' colours to the marble's colour
-    for (i = 0; i < 144; i++) {
-        marble_draw_bmp_pri[i] = Get_Primary_Hex(marble->colour);
-    }
-    
-    for (i = 0; i < 12; i++) {
-        marble_draw_bmp_sec[i] = Get_Secondary_Hex(marble->colour);
-    }
-        
-    // Render the circle using a series of bitmaps
-    GLCD_Bitmap(x + 2,  y + 2,  12, 12, (unsigned char *)marble_draw_bmp_pri);
-    
-    GLCD_Bitmap(x + 5,  y,      6,  2,  (unsigned char *)marble_draw_bmp_sec);
-    GLCD_Bitmap(x + 5,  y + 14, 6,  2,  (unsigned char *)marble_draw_bmp_sec);
-    GLCD_Bitmap(x,      y + 5,  2,  6,  (unsigned char *)marble_draw_bmp_sec);
-    GLCD_Bitmap(x + 14, y + 5,  2,  6,  (unsigned char *)marble_draw_bmp_sec);
-    
-    GLCD_Bitmap(x + 3,  y + 1,  2,  1,  (unsigned char *)marble_draw_bmp_pri);
-    GLCD_Bitmap(x + 11, y + 1,  2,  1,  (unsigned char *)marble_draw_bmp_pri);
-    GLCD_Bitmap(x + 3,  y + 14, 2,  1,  (unsigned char *)marble_draw_bmp_pri);
-    GLCD_Bitmap(x + 11, y + 14, 2,  1,  (unsigned char *)marble_draw_bmp_pri);
-    GLCD_Bitmap(x + 1,  y + 3,  1,  2,  (unsigned char *)marble_draw_bmp_pri);
-    GLCD_Bitmap(x + 1,  y + 11, 1,  2,  (unsigned char *)marble_draw_bmp_pri);
-    GLCD_Bitmap(x + 14, y + 3,  1,  2,  (unsigned char *)marble_draw_bmp_pri);
-    GLCD_Bitmap(x + 14, y + 11, 1,  2,  (unsigned char *)marble_draw_bmp_pri);
-}
-
-// Render the bullet marble patcher for a marble at position x,y
-void Draw_Bullet_Patch(float marble_x, float marble_y) {
-    unsigned int x = marble_x - 12;
-    unsigned int y = marble_y - 12;
-    
-    // Render the patcher using a series of bitmaps
-    GLCD_Bitmap(x,      y + 4,  4, 16,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 3,  y,      14, 4,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 3,  y + 20, 14, 4,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 4,  y + 4,  1,  5,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 4,  y + 15, 1,  5,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 5,  y + 4,  1,  3,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 5,  y + 17, 1,  3,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 6,  y + 4,  1,  2,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 6,  y + 18, 1,  2,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 7,  y + 4,  2,  1,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 7,  y + 19, 2,  1,  (unsigned char *)marble_patch_bmp);
-} 
-
-// Render the train marble patcher for a marble at position x,y
-void Draw_Train_Patch(float marble_x, float marble_y) {
-    unsigned int x = marble_x - 8;
-    unsigned int y = marble_y - 9;
-    
-    // Render the patcher using a series of bitmaps
-    GLCD_Bitmap(x + 5,  y,      6,  1,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x,      y + 1,  5,  1,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 11, y + 1,  5,  1,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x,      y + 2,  3,  1,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 13, y + 2,  3,  1,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x,      y + 3,  2,  1,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 14, y + 3,  2,  1,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x,      y + 4,  1,  2,  (unsigned char *)marble_patch_bmp);
-    GLCD_Bitmap(x + 15, y + 4,  1,  2,  (unsigned char *)marble_patch_bmp);
-}   
-
-// Render the cannon given its angle and the chambered and spare colours
-void Draw_Cannon(float angle, Colour cannon_colour, Colour chambered_colour, Colour spare_colour) {
-    // Used to draw the cannon
-    Marble renderer = { CANNON_X, CANNON_Y, WHITE};
-
-    // Set the drawing marble to the chambered colour and draws it
-    renderer.colour = chambered_colour;
-    Draw_Marble(&renderer);
-
-    // Repeats for the spare colour, setting its position according to rotation
-    Move_Marble(&renderer, -16 * cos(angle), -16 * sin(angle));
-    renderer.colour = spare_colour;
-    Draw_Marble(&renderer);
-
-    // Draws the arm of the cannon based on its rotation
-    renderer.colour = cannon_colour;
-    Move_Marble(&renderer, 32 * cos(angle), 32 * sin(angle));
-    Draw_Marble(&renderer);
-    Move_Marble(&renderer, 16 * cos(angle), 16 * sin(angle));
-    Draw_Marble(&renderer);
-}
-
-// Check two marbles for collision
-bool Marble_Collision(Marble *m1, Marble *m2) {
-    return (sqrt(SQUARE(m2->x - m1->x) + SQUARE(m2->y - m1->y)) < MARBLE_DIAMETER);
-}
-
-// Move the train root marble forward, and push all marbles in collision
-void Move_Marble_Train(Marble *root, float time_elapsed) {
-    // Start at root
-    Marble *current = root;        
-   
-    // Move the root marble
-    Move_Marble(current, 0, TRAIN_SPEED * time_elapsed);
-
-    // If the next marble is in contact, move it ahead of the current marble
-    // Stop when no marbles are left or in contact
-    while (current->next != NULL && Marble_Collision(current, current->next)) {
-        Position_Marble(current->next, current->x, current->y + MARBLE_DIAMETER - 1); // -1 to ensure collisions
-        current = current->next;
-    }
-}
-
-// Move the bullet marble, given the flight angle and time elapsed
-// Also places the marble into the train if it makes a collision
-// Returns true if flight ended, otherwise returns false
-bool Move_Bullet(Marble *bullet_ptr, Marble **root, float angle, float time_elapsed) {
-    Marble *current = *root, *prev = *root;
-    
-    // Move the marble in its flight vector
-    Move_Marble(bullet_ptr, time_elapsed * BULLET_SPEED * cos(angle), time_elapsed * BULLET_SPEED * sin(angle));
-
-    // Ensure marble is within screen boundaries
-    if (bullet_ptr->x >= WINDOW_X - MARBLE_DIAMETER || bullet_ptr->x <= 0 + MARBLE_DIAMETER ||
-        bullet_ptr->y >= WINDOW_Y - MARBLE_DIAMETER || bullet_ptr->y <= 0 + MARBLE_DIAMETER) {
-        free(bullet_ptr);
-        return true;
-    }
-
-    // Iterate through the marble train checking for collisions
-    while (current != NULL) {
-        if (Marble_Collision(bullet_ptr, current)) {
-            // Collision found
-            if (bullet_ptr->y < current->y) {
-                // Bullet made a collision from the top
-                // Update the linked list nodes to add the bullet
-                if (current == *root) {
-                    *root = bullet_ptr;
-                }
-                else {
-                    prev->next = bullet_ptr;
-                }
-                bullet_ptr->next = current;
-                
-                // Move the bullet into position and shift the train
-                Position_Marble(bullet_ptr, current->x, current->y);
-                Move_Marble_Train(bullet_ptr, 0);
-            }
-            else {
-                // Bullet made a collision from the bottom
-                // Update the linked list nodes to add the bullet
-                bullet_ptr->next = current->next;
-                current->next = bullet_ptr;
-                
-                // Move the bullet into position and shift the train
-                Position_Marble(bullet_ptr, current->x, current->y);
-                Move_Marble_Train(current, 0);
-            }
-
-            return true;
-
-        }
-        else {
-            prev = current;
-            current = current->next;
-        }
-    }
-
-    return false;
-}
-
-// Check the marble train for bullet matches and eliminate them
-// Return true if marbles were collapsed, else returns false
-bool Collapse_Marbles(Marble **root, Marble *bullet) {
-    Colour collapse_colour = bullet->colour;
-    Marble *current = *root, *pre_collapse = NULL,
-           *temp_1, *temp_2;
-    int num_to_collapse = 0, i;
-    bool bullet_found = false, end_sequence = false;
-
-    // Iterate through the marble train
-    while (current != NULL) {
-        // Check if the bullet has been found yet
-        if (current == bullet) {
-            bullet_found = true;
-        }
-        // Check if there is a disconnection (end of train, change in colour, or no collision)
-        if (current->colour != collapse_colour || current->next == NULL ||
-            current->next->colour != collapse_colour || !Marble_Collision(current, current->next)) {
-            end_sequence = true;
-        }
-        // Check if the current marble should be collapsed
-        if (current->colour == collapse_colour) {
-            num_to_collapse++;
-        }
-        
-        if (end_sequence) {
-            // There is a disconnection
-            if (bullet_found) {
-                // Bullet is within the last sequence. Must collapse or exit
-                if (num_to_collapse >= 3) {
-                    // Collapse
-                    // Handle the linked list nodes
-                    if (pre_collapse == NULL) {
-                        temp_1 = *root;
-                        *root = current->next;
-                    }
-                    else {
-                        temp_1 = pre_collapse->next;
-                        pre_collapse->next = current->next;
-                    }
-                            
-                    // Delete the marbles
-                    for (i = 0; i < num_to_collapse; i++) {
-                        temp_2 = temp_1->next;
-                        free(temp_1);
-                        temp_1 = temp_2;
-                    }
-                            
-                    return true;
-                }                  
-                else {
-                    // Exit
-                    return false;
-                }
-            }
-            else {
-                // Bullet not found yet, go to the next sequence
-                num_to_collapse = 0;
-                pre_collapse = current;
-                end_sequence = false;
-            }
-        }
-        
-        // Move to the next marble
-        current = current->next;
-    }
-    
-    return false;
-}
-
-// Generate a random number given a seed
-uint16_t Random_Number() {
-    bit  = ((seed >> 0) ^ (seed >> 2) ^ (seed >> 3) ^ (seed >> 5) ) & 1;
-    return seed = (seed >> 1) | (bit << 15);
-}
-
-// Generate a random colour
-Colour Generate_Colour() {
-    switch (Random_Number() % 4) {
-        case 0: return RED;
-        case 1: return BLUE;
-        case 2: return GREEN;
-        case 3: return YELLOW;
-        default: return MAGENTA; // Should never get here
-    }
-}
-
-// ISRs ----------------------------------------------------------------------------------------------------------------
-// Press button ISR
-void EINT3_IRQHandler() {
-    if (state == TITLE_SCREEN) {
-        // Start game
-        state = GAME_ON;
-        clear_screen = true;
-    }
-    else {
-        // Fire marble
-        shoot_marble = true;
-    }
-    
-    // Clear pending interrupt
-    LPC_GPIOINT->IO2IntClr |= (1 << 10);
-}
-
-// Tasks ---------------------------------------------------------------------------------------------------------------
-// Potentiometer read task
-__task void Potentiometer_Read() {
-    uint32_t reading = 0;
-    
-    // Initialize potentiometer and ADC converter
-    LPC_PINCON->PINSEL1 &= ~(0x03 << 18);
-    LPC_PINCON->PINSEL1 |= (0x01 << 18);
-    LPC_SC->PCONP |= (1 << 12);
-    LPC_ADC->ADCR = (1 << 2) |
-                    (4 << 8) |
-                    (1 << 21);
-    
-    // Repeatedly read and store the potentiometer value
-    for(ever) {
-        // Start new reading
-        LPC_ADC->ADCR |= (1 << 24);
-    
-        // Await reading
-        do {
-            reading = LPC_ADC->ADGDR;
-        } while (!(reading & 0x80000000));
-        
-        // Store in global variable
-        os_mut_wait(&mut_pot, 0xFFFF); // --------------------------------------
-        pot_position = (reading & 0x0000FFFF) >> 4;
-        os_mut_release(&mut_pot); // -------------------------------------------
-        
-        os_tsk_pass();
-    }
-}
-
-// Joystick read task
-__task void Joystick_Read() {
-    bool joystick_prev_held = false;
-    
-    // Initialize joystick
-    LPC_GPIO1->FIODIR &= ~0x07900000;
-    
-    // Repeatedly check the joystick status and set a flag if it is moved in
-    for(ever) {
-        // If any of the joystick bits are 0, the joystick is held
-        if (~LPC_GPIO1->FIOPIN & 0x07900000) {
-            if (!joystick_prev_held) {
-                // Store in global variables
-                os_mut_wait(&mut_joy, 0xFFFF); // ------------------------------
-                swap_marble = true;
-                os_mut_release(&mut_joy); // -----------------------------------
-            }
-            joystick_prev_held = true;
-        }
-        else {
-            joystick_prev_held = false;
-        }
-        
-        os_tsk_pass();
-    }
-}
-
-// Game logic handling task
-__task void Game_Logic() {
-    int i;
-    float temp_angle = 0;
-    float prev_time, time_elapsed = 0;
-    Colour temp_colour;
-    Marble *temp;
-    
-    // Initialize timer
-    timer_setup();
-    
-    // Wait while the game starts
-    while (state == TITLE_SCREEN) {
-        os_tsk_pass();
-    }
-    
-    // Generate random seed given the start time
-    // Should be random due to the human factor
-    seed = timer_read();
-    
-    // Set the score in the display string
-    sprintf(score_str, "%03d", score);
-    
-    // Initialize the bullet marble
-    bullet = malloc(sizeof(Marble));
-    bullet->colour = Generate_Colour();
-    Position_Marble(bullet, CANNON_X, CANNON_Y);
-    
-    // Generate the spare colour
-    chambered_colour = bullet->colour;
-    spare_colour = Generate_Colour();
-    
-    // Initialize the marble train root
-    train_root = malloc(sizeof(Marble));
-    Position_Marble(train_root, WINDOW_X - 40, MARBLE_DIAMETER);
-    train_root->colour = Generate_Colour();
-    temp = train_root;
-    
-    // Generate the marble train
-    for (i = 1; i < NUM_STARTING_MARBLES; i++) {
-        temp->next = malloc(sizeof(Marble));
-        temp->next->colour = Generate_Colour();
-        Position_Marble(temp->next, WINDOW_X - 40, i * MARBLE_DIAMETER - 1);
-        temp = temp->next;
-    }
-    
-    // Clear a button press bug and reset the timer
-    shoot_marble = false;
-    prev_time = timer_read() / 1000000.f;
-        
-    // Game loop
-    for(ever) {
-        // Elapsed time since last iteration
-        time_elapsed = timer_read() / 1000000.f - prev_time;
-        prev_time += time_elapsed;
-        
-        // Read the potentiometer position and convert to angle
-        os_mut_wait(&mut_pot, 0xFFFF); // --------------------------------------
-        temp_angle =  (4095 - pot_position) / 34.125 - 60;
-        os_mut_release(&mut_pot); // -------------------------------------------
-        
-        // Read the joystick flag and swap the spare and chambered marbles
-        os_mut_wait(&mut_joy, 0xFFFF); // --------------------------------------
-        if (swap_marble) {
-            swap_marble = false;
-            temp_colour = spare_colour;
-            spare_colour = chambered_colour;
-            chambered_colour = temp_colour;
-            
-            if (!marble_airborne) {
-                bullet->colour = chambered_colour;
-            }
-        }
-        os_mut_release(&mut_joy); // -------------------------------------------
-        
-        os_mut_wait(&mut_LCD, 0xFFFF); // --------------------------------------
-        // Move the marble train based on time elapsed
-        Move_Marble_Train(train_root, time_elapsed);
-        
-        // Rotate the cannon based on the potentiometer angle
-        cannon_angle = (int)temp_angle;
-        
-        // Move the bullet if it is airborne
-        if (marble_airborne) {
-            // Prevent bugs
-            shoot_marble = false;
-            
-            // Move the bullet and check for bullet collision with the train
-            bullet_collision = Move_Bullet(bullet, &train_root, firing_angle, time_elapsed);
-            
-            if (bullet_collision) {
-                // Bullet joined the train
-                // Check and conditionally collapse the marbles around the bullet
-                if (Collapse_Marbles(&train_root, bullet)) {
-                    // Gain ponits upon successful collapse
-                    score += 10 * (score_multiplier + 1);
-                    score_multiplier++;
-                    sprintf(score_str, "%03d", score);
-                }
-                else {
-                    // Lose multiplier
-                    score_multiplier = 0;
-                }
-                
-                // Generate a new marble
-                marble_airborne = false;
-                bullet = malloc(sizeof(Marble));
-                bullet->colour = chambered_colour;
-                Position_Marble(bullet, CANNON_X, CANNON_Y);
-            }
-            else {
-                // Position the bullet patcher
-                bullet_patch_x = bullet->x;
-                bullet_patch_y = bullet->y;
-            }
-        }
-        else if (shoot_marble) {
-            // Marble fired
-            // Set the flags and generate a new spare colour
-            shoot_marble = false;
-            marble_airborne = true;
-            firing_angle = RADIANS(cannon_angle);
-            chambered_colour = spare_colour;
-            spare_colour = Generate_Colour();
-        }
-        
-        // Win condition
-        if (train_root == NULL) {
-            // Train cleared, game won
-            // Advance to the win screen
-            state = FATALITY;
-            clear_screen = true;
-            os_mut_release(&mut_LCD); // ---------------------------------------
-            break; // Out of the for(ever) loop
-        }
-        else {
-            // Iterate through train to the front marble
-            temp = train_root;
-            while (temp->next != NULL) {
-                temp = temp->next;
-            }
-            
-            // Check front marble's position
-            if (temp->y >= WINDOW_Y) {
-                // Front marble passed the finish line, game lost
-                // Advance to the loss screen
-                state = YOU_DIED;
-                clear_screen = true;
-                os_mut_release(&mut_LCD); // -----------------------------------
-                break; // Out of the for(ever) loop
-            }
-        }
-        
-        os_mut_release(&mut_LCD); // -------------------------------------------
-        
-        os_tsk_pass();
-    }
-    
-    // Idle through the end screen
-    while (true) {
-        os_tsk_pass();
-    }
-}
-
-// LCD graphics rendering task
-__task void LCD_Display() {
-    int k = 0;
-    int new_angle = 0, old_angle = 0;
-    Marble *temp;
-    
-    // Initialize LCD
-    GLCD_Init();
-    GLCD_Clear(BACKGROUND_COLOUR);
-    GLCD_SetBackColor(BACKGROUND_COLOUR);
-    GLCD_SetTextColor(TEXT_COLOUR);
-    
-    // Initialize marble patcher bitmap
-    for (k = 0; k < 8; k++) {
-        marble_patch_bmp[k] = BACKGROUND_COLOUR;
-    }
-        
-    // Graphics loop
-    for(ever) {
-        os_mut_wait(&mut_LCD, 0xFFFF); // --------------------------------------
-        
-        // Clear screen if prompted
-        if (clear_screen) {
-            clear_screen = false;
-            GLCD_Clear(BACKGROUND_COLOUR);
-        }
-        
-        // Render title screen if in that state
-        if (state == TITLE_SCREEN) {
-            GLCD_DisplayString(5, 1, 1, (unsigned char*)title_str);
-            GLCD_DisplayString(20, 10, 0, (unsigned char*)inst_str);
-        }
-        else if (state == GAME_ON) {
-            // Clear the screen upon collision to fix graphics bugs
-            if (bullet_collision) {
-                GLCD_Clear(BACKGROUND_COLOUR);
-                bullet_collision = false;
-            }
-        
-            // Draw the cannon patcher
-            new_angle = cannon_angle;
-            if (new_angle != old_angle) {
-                Draw_Cannon(RADIANS(old_angle), BACKGROUND_COLOUR, BACKGROUND_COLOUR, BACKGROUND_COLOUR);
-            }
-            old_angle = new_angle;
-            
-            // Draw the bullet patcher
-            Draw_Bullet_Patch(bullet_patch_x, bullet_patch_y);
-            
-            // Draw the train patcher for each marble in the train
-            temp = train_root;
-            while (temp != NULL) {
-                Draw_Train_Patch(temp->x, temp->y);
-                temp = temp->next;
-            }
-            
-            // Draw each marble in the train
-            temp = train_root;
-            while (temp != NULL) {
-                Draw_Marble(temp);
-                temp = temp->next;
-            }
-            
-            // Draw the cannon
-            Draw_Cannon(RADIANS(new_angle), CANNON_COLOUR, chambered_colour, spare_colour);
-            
-            // Draw the bullet
-            if (marble_airborne) {
-                Draw_Marble(bullet);
-            }
-            
-            // Display the score
-            GLCD_DisplayString(12, 0, 1, (unsigned char*)score_str);
-            
-        }
-        else {
-            // End screen
-            if (state == FATALITY) {
-                // Display victory screen
-                GLCD_DisplayString(5, 4, 1, (unsigned char*)gg_win_str);
-            }
-            else {
-                // Display loss screen
-                GLCD_DisplayString(5, 3, 1, (unsigned char*)gg_lose_str);
-            }
-            
-            // Display score
-            GLCD_DisplayString(7, 3, 1, (unsigned char*)gg_score_str);
-            GLCD_DisplayString(7, 10, 1, (unsigned char*)score_str);
-        }
-        
-        os_mut_release(&mut_LCD); // -------------------------------------------
-       
-        os_tsk_pass();
-    }
-}
-
-// LED display task
-// Switches on two LEDs, from right to left, for each multiplier
-__task void LED_Output() {
-    // Initialize LEDs
-    LED_setup();
-    
-    // Repeatedly display the score multiplier on the LEDs
-    for(ever) {
-        // Clear the LEDs
-        LPC_GPIO1->FIOCLR |= 0xB0000000;
-        LPC_GPIO2->FIOCLR |= 0x7C;
-        
-        os_mut_wait(&mut_LED, 0xFFFF); // --------------------------------------
-        switch (score_multiplier) {
-            case 0: LPC_GPIO2->FIOSET |= 0x60;
-                    break;
-            
-            case 1: LPC_GPIO2->FIOSET |= 0x78;
-                    break;
-            
-            case 2: LPC_GPIO1->FIOSET |= 0x80000000;
-                    LPC_GPIO2->FIOSET |= 0x7C;
-                    break;
-            
-            case 3: LPC_GPIO1->FIOSET |= 0xB0000000;
-                    LPC_GPIO2->FIOSET |= 0x7C;
-                    break;
-            
-            default: break;
-        }
-        os_mut_release(&mut_LED); // -------------------------------------------
-        
-        os_tsk_pass();
-    }
-}
-    
-// Parent task for initialization and start-up
-__task void Startup_Task() {
-    // Initialize semaphores
-    os_mut_init(&mut_LED);
-    os_mut_init(&mut_LCD);
-    os_mut_init(&mut_pot);
-    
-    // Start all tasks
-    os_tsk_create(Potentiometer_Read, 1);
-    os_tsk_create(Joystick_Read, 1);
-    os_tsk_create(Game_Logic, 1);
-    os_tsk_create(LCD_Display, 1);
-    os_tsk_create(LED_Output, 1);
-    
-    // Delete self
-    os_tsk_delete_self();
-}
-
-// Main ----------------------------------------------------------------------------------------------------------------
-int main() {
-    // Initialize interrupts
-    LPC_GPIOINT->IO2IntEnF |= (1 << 10);
-    LPC_GPIOINT->IO2IntEnR &= ~(1 << 10);
-    NVIC_EnableIRQ(EINT3_IRQn);
-    
-    // Start the start-up task
-    os_sys_init(Startup_Task);
-    return 0;
-}
-
-
-
-
-
+// MARBLE KOMBAT
+// Hashem Botma, Hsuan Ling Chen
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rtl.h>
+#include <time.h>
+#include "GLCD.h"
+#include "GLCD_ext.h"
+#include "GLCD_List.h"
+#include "repeat.h"
+#include "fixed.h"
+#include "track.h"
+#include "hal.h"
+#include "replay.h"
+
+#define ever ;;
+
+// Macro Functions -----------------------------------------------------------------------------------------------------
+#define SQUARE(x)       ((x) * (x))                     // Squares a number
+
+// Typedefs ------------------------------------------------------------------------------------------------------------
+// Colour enum type for marbles
+typedef enum {
+    BLACK = 0x0000,
+    RED,
+    BLUE,
+    GREEN,
+    YELLOW,
+    MAGENTA,
+    WHITE = 0xFFFF,
+} Colour;
+
+// Game state enum type for starting and ending game
+typedef enum {
+    TITLE_SCREEN,
+    GAME_ON,
+    FATALITY,
+    YOU_DIED,
+} Game_State;
+
+// Marble struct type
+typedef struct Marble Marble;
+struct Marble {
+    Fixed x;
+    Fixed y;
+    Fixed prev_x; // Position before the last simulation step
+    Fixed prev_y;
+    Colour colour;
+    Marble *next; // Free list link while in the pool
+};
+
+// Marble handle type, a pool slot plus the generation it was allocated in
+// Stale handles to released marbles are caught by Marble_Get in debug builds
+typedef uint32_t Marble_Handle;
+
+// Bullet flight result enum type
+typedef enum {
+    BULLET_FLYING,
+    BULLET_LOST, // Left the screen
+    BULLET_JOINED, // Joined the train
+} Bullet_Result;
+
+// Sprite struct type, a marble to be composited onto the screen
+typedef struct {
+    int16_t x; // Top left corner
+    int16_t y;
+    const uint16_t *image; // MARBLE_DIAMETER squared pixels, top row first
+} Sprite;
+
+// Screen rectangle struct type, x1 and y1 are exclusive
+typedef struct {
+    int16_t x0;
+    int16_t y0;
+    int16_t x1;
+    int16_t y1;
+} Rect;
+
+// Snapshot marble struct type, a marble as seen by the renderer
+typedef struct {
+    int16_t x; // Centre
+    int16_t y;
+    int16_t prev_x; // Centre before the last simulation step
+    int16_t prev_y;
+    Colour colour;
+} Snapshot_Marble;
+
+// Constants -----------------------------------------------------------------------------------------------------------
+#define NUM_STARTING_MARBLES    7               // Marbles in train at start
+#define MARBLE_DIAMETER         16              // Any literal up to 32, sprites are generated from it
+#define TRAIN_SPEED             8               // Pixels per second
+#define BULLET_SPEED            125             // Pixels per second
+#define RETRACT_SPEED           64              // Pixels per second a segment is drawn back to a matching one
+#define SIM_RATE                120             // Simulation steps per second
+#define SIM_STEP_US             (1000000 / SIM_RATE)
+#define MAX_SIM_STEPS           8               // Steps per wake before dropping time
+#define SIM_ALPHA_ONE           256             // Interpolation fraction of a whole step
+#define TRAIN_STEP              FIXED_FRAC(TRAIN_SPEED * SIM_STEP_US, 1000000) // Pixels per step
+#define BULLET_STEP             FIXED_FRAC(BULLET_SPEED * SIM_STEP_US, 1000000)
+#define RETRACT_STEP            FIXED_FRAC(RETRACT_SPEED * SIM_STEP_US, 1000000)
+#define MARBLE_SPACING          TO_FIXED(MARBLE_DIAMETER - 1) // Between train marbles in contact, -1 to ensure collisions
+#ifndef NUM_TRAINS
+#define NUM_TRAINS              1               // Trains in the level, each on its own track from level_tracks, host/batch_cost.c lays more
+#endif
+#define MAX_CANNON_ANGLE        FIXED_TRIG_MAX  // Degrees either side of horizontal
+#define COLLIDE_SHIFT           8               // Q16.16 to Q8 for collision tests
+#define COLLIDE_DIST            (MARBLE_DIAMETER << (FIXED_SHIFT - COLLIDE_SHIFT))
+#define SWEEP_MAX_STEP          32              // Longest bullet step in pixels, keeps the sweep in 64 bits
+#define POT_MAX                 4095            // Full scale potentiometer reading
+#define POT_PER_DEGREE_X8       273             // Potentiometer counts per degree (34.125), times 8
+#define WINDOW_X                240             // Pixel width
+#define WINDOW_Y                320             // Pixel height
+
+#define BACKGROUND_COLOUR       BLACK           // For clearing screen and patching
+#define TEXT_COLOUR             WHITE
+#define CANNON_COLOUR           WHITE 
+#define CANNON_X                25              // X position of cannon
+#define CANNON_Y                WINDOW_Y / 2    // Y position of cannon
+
+// Marble colour codes
+#define HEX_WHITE_PRI           0xFFFF
+#define HEX_WHITE_SEC           0xBDF7
+#define HEX_RED_PRI             0xF800
+#define HEX_RED_SEC             0xFC10
+#define HEX_BLUE_PRI            0x05DF
+#define HEX_BLUE_SEC            0x51DF
+#define HEX_GREEN_PRI           0x5DA0
+#define HEX_GREEN_SEC           0xA7E7
+#define HEX_YELLOW_PRI          0xFE60
+#define HEX_YELLOW_SEC          0xFD00
+#define HEX_BLACK               0x0000
+#define HEX_INVALID             0xD01F          // Should never be drawn
+#define SPRITE_CLEAR            0x0001          // Transparent sprite pixel, not a marble colour
+
+#ifndef MAX_TRAIN
+#define MAX_TRAIN               40              // Train capacity, host/logic_cost.c builds longer ones
+#endif
+#define MAX_SNAPSHOT_MARBLES    (NUM_TRAINS * MAX_TRAIN) // Train marbles passed to the renderer
+#ifndef MAX_BULLETS
+#define MAX_BULLETS             1               // Bullets in flight at once, host tests and benches fly more
+#endif
+#define MAX_MARBLES             MAX_BULLETS     // Marble pool, loose marbles outside the trains
+#define MAX_SPRITES             (MAX_SNAPSHOT_MARBLES + MAX_BULLETS + 4) // Trains, bullets and cannon
+#define SNAPSHOT_FRESH          0x04            // Set on the ready index until the renderer takes it
+#define MAX_DAMAGE              16              // Damaged rectangles per frame
+#define STRIP_HEIGHT            16              // Rows per strip, trades RAM for window writes
+#define NUM_STRIPS              ((WINDOW_Y + STRIP_HEIGHT - 1) / STRIP_HEIGHT)
+#define FONT_W                  16              // Score text font (16x24)
+#define FONT_H                  24
+#define SCORE_X                 0               // Score text box (line 12)
+#define SCORE_Y                 (12 * FONT_H)
+#define SCORE_DIGITS            10              // Widest score text, any uint32_t in decimal
+#define SCORE_H                 FONT_H
+
+#define EVT_LCD_DMA             0x0001          // LCD pixel burst finished
+#define EVT_LCD_FRAME           0x0002          // New snapshot or display list commands
+#define EVT_GAME_START          0x0001          // Button pressed on the title screen
+#define EVT_LED_UPDATE          0x0001          // Score multiplier changed
+#define INPUT_INTERVAL          2               // RTX ticks between input samples
+#define REPLAY_INTERVAL         10              // RTX ticks between input log drains, with REPLAY_RECORD
+#define REPLAY_CHUNK            64              // Input log bytes written at a time
+
+// A faster bullet or slower simulation must keep the bullet step within the sweep's range
+#if (BULLET_SPEED * SIM_STEP_US / 1000000 > SWEEP_MAX_STEP)
+#error "Bullet step is longer than SWEEP_MAX_STEP"
+#endif
+
+// Distance along a track type, Q16.16 px
+// A train too long for a 32-bit distance, as only the host benches build, takes 64 bits and
+// is clamped to the track's end, all the track tables hold, before each lookup
+#if (MAX_TRAIN + 2) * (MARBLE_DIAMETER - 1) > 0x7FFF
+typedef int64_t Distance;
+#define ON_TRACK(track, d)      ((d) < (track)->length ? (Fixed)(d) : (track)->length)
+#else
+typedef Fixed Distance;
+#define ON_TRACK(track, d)      (d)
+#endif
+#define TRAIN_SPAN(n)           ((Distance)(n) * MARBLE_SPACING) // From a segment's first marble to its nth
+
+// Count game logic operations, the same on any CPU, for the host gate and benches
+// Built with COUNT_LOGIC_OPS only, so the board's hot paths carry no bookkeeping
+#ifdef COUNT_LOGIC_OPS
+#define LOGIC_OPS(n)            (logic_ops += (n))
+#else
+#define LOGIC_OPS(n)
+#endif
+
+// Run count type, marbles before or after one in its run, as narrow as MAX_TRAIN allows
+#if MAX_TRAIN > 0x10000
+#error "MAX_TRAIN is too long for the run counts"
+#elif MAX_TRAIN > 0x100
+typedef uint16_t Run_Count;
+#else
+typedef uint8_t Run_Count;
+#endif
+
+// Train segment struct type, marbles in contact that move as one
+typedef struct {
+    int first; // Index of the segment's rearmost marble
+    Distance offset; // Its distance along the track, the rest follow at MARBLE_SPACING
+    Distance prev_offset; // Before the last simulation step
+} Segment;
+
+// Train struct type, packed marble arrays from the root (index 0, track start) to the front
+// Marble positions come from their segment, so moving a segment moves all of its marbles
+typedef struct {
+    int length;
+    Colour colour[MAX_TRAIN];
+    Run_Count run_back[MAX_TRAIN]; // Marbles of the same colour in contact before this one
+    Run_Count run_ahead[MAX_TRAIN]; // And after it, so a marble's run is found without scanning
+    int num_segments;
+    Segment segment[MAX_TRAIN + 1]; // From the rear, one spare for splitting
+    const Track *track;
+} Train;
+
+// Bullet struct type, a marble in flight
+typedef struct {
+    Marble_Handle marble; // 0 while the slot is free
+    Fixed step_x; // Flight vector per simulation step
+    Fixed step_y;
+} Bullet;
+
+// Pending hit struct type, found by the batched collision pass and applied after it
+typedef struct {
+    int bullet; // Bullet slot
+    int train;
+    int index; // Train marble hit
+    uint32_t toi; // Time of impact within the step, Q16.16
+} Pending_Hit;
+
+// Frame snapshot struct type, everything the renderer needs from one game logic iteration
+typedef struct {
+    Game_State state;
+    uint32_t alpha; // Time since the last step, out of SIM_ALPHA_ONE
+    int cannon_angle;
+    Colour chambered_colour;
+    Colour spare_colour;
+    int num_bullets;
+    Snapshot_Marble bullet[MAX_BULLETS];
+    int num_marbles;
+    Snapshot_Marble train[MAX_SNAPSHOT_MARBLES];
+    char score_str[SCORE_DIGITS + 1];
+} Frame_Snapshot;
+
+// Global variables ----------------------------------------------------------------------------------------------------
+// Mutexes for data sharing
+OS_MUT mut_LED, mut_pot, mut_joy, mut_list;
+
+// Task IDs for event signalling
+OS_TID tsk_LCD, tsk_game, tsk_LED;
+
+// Inputs
+Game_State state;
+uint32_t pot_position;
+
+// Global marbles
+Train trains[NUM_TRAINS];
+uint32_t train_high_water; // Longest train since start-up, for sizing MAX_TRAIN
+Bullet bullets[MAX_BULLETS]; // Projectile marbles, by slot
+
+// Level tracks, one per train: track_column, track_zigzag or track_spiral
+const Track *const level_tracks[NUM_TRAINS] = { &track_column };
+
+// Marble pool, free marbles are linked through next
+Marble marble_pool[MAX_MARBLES];
+uint16_t pool_generation[MAX_MARBLES];
+Marble *pool_free;
+uint32_t pool_used, pool_high_water;
+
+// Game logic
+bool shoot_marble, swap_marble;
+int cannon_angle; // Degrees
+Colour chambered_colour, spare_colour;
+
+// Score tracking
+uint32_t score, score_multiplier;
+
+// Random number generation
+uint16_t seed;
+unsigned bit;
+
+// Frame snapshots, triple buffered from the game logic to the renderer without locks
+// Each side owns one buffer, the third is swapped through snapshot_ready
+Frame_Snapshot snapshots[3];
+volatile uint32_t snapshot_ready = 1; // Latest published buffer, with SNAPSHOT_FRESH
+uint32_t snapshot_back = 0; // Written by the game logic
+uint32_t snapshot_front = 2; // Read by the renderer
+
+// Graphics
+Sprite sprites[2][MAX_SPRITES]; // Previous and current frame
+int num_sprites[2];
+Rect damage[MAX_DAMAGE];
+int num_damage;
+uint16_t strip_bmp[2][WINDOW_X * STRIP_HEIGHT]; // One is composed while the other is streamed
+int strip_buf; // The buffer last handed to the driver, kept across frames
+uint32_t frame_pixels; // Pixels pushed in the last frame
+
+// Frame cost accounting, in HAL_Cycles units
+uint32_t logic_cycles; // Running total of the game logic, only written by it
+uint32_t lcd_wait_cycles; // Running total of the renderer's sleeps on pixel bursts
+uint32_t logic_ops; // Running total of the game logic's marble operations, with COUNT_LOGIC_OPS
+
+// Marble sprites, generated by the compiler for MARBLE_DIAMETER
+// Pixel offsets from the marble centre are in half pixels
+// Pixels inside the circle are the primary colour, except the secondary colour
+// highlights in the middle of the outer rim on each side
+#if MARBLE_DIAMETER > 32
+#error "Marble sprites are generated for diameters up to 32"
+#endif
+#define SPRITE_OFFSET(i)            (2 * (i) + 1 - MARBLE_DIAMETER)
+#define SPRITE_ABS(v)               ((v) < 0 ? -(v) : (v))
+#define SPRITE_INSIDE(r, c)         (SQUARE(SPRITE_OFFSET(c)) + SQUARE(SPRITE_OFFSET(r)) <= SQUARE(MARBLE_DIAMETER))
+#define SPRITE_RIM(along, across)   (SPRITE_ABS(SPRITE_OFFSET(along)) < 3 * MARBLE_DIAMETER / 8 && \
+                                     SPRITE_ABS(SPRITE_OFFSET(across)) > MARBLE_DIAMETER - MARBLE_DIAMETER / 4)
+#define SPRITE_PIXEL(pri, sec, r, c) (!SPRITE_INSIDE(r, c) ? SPRITE_CLEAR : \
+                                     SPRITE_RIM(c, r) || SPRITE_RIM(r, c) ? (sec) : (pri)),
+#define SPRITE_ROW(pri, sec, r)     REPEAT_COLS(MARBLE_DIAMETER, SPRITE_PIXEL, pri, sec, r)
+#define SPRITE_IMAGE(pri, sec)      { REPEAT_ROWS(MARBLE_DIAMETER, SPRITE_ROW, pri, sec) }
+
+const uint16_t sprite_white[]   = SPRITE_IMAGE(HEX_WHITE_PRI, HEX_WHITE_SEC);
+const uint16_t sprite_red[]     = SPRITE_IMAGE(HEX_RED_PRI, HEX_RED_SEC);
+const uint16_t sprite_blue[]    = SPRITE_IMAGE(HEX_BLUE_PRI, HEX_BLUE_SEC);
+const uint16_t sprite_green[]   = SPRITE_IMAGE(HEX_GREEN_PRI, HEX_GREEN_SEC);
+const uint16_t sprite_yellow[]  = SPRITE_IMAGE(HEX_YELLOW_PRI, HEX_YELLOW_SEC);
+const uint16_t sprite_black[]   = SPRITE_IMAGE(HEX_BLACK, HEX_BLACK);
+const uint16_t sprite_invalid[] = SPRITE_IMAGE(HEX_INVALID, HEX_INVALID);
+
+// Text display
+char score_str[SCORE_DIGITS + 1], title_str[] = "MARBLE KOMBAT", inst_str[] = "PRESS BUTTON TO BEGIN", gg_win_str[] = "FATALITY!", gg_lose_str[] = "YOU DIED", gg_score_str[] = "SCORE: ";
+  
+// Functions -----------------------------------------------------------------------------------------------------------
+// Place the marble at a position x,y
+void Position_Marble(Marble *marble, Fixed x, Fixed y) {
+    marble->x = x;
+    marble->y = y;
+}
+
+// Remember the marble's position as the start of the next simulation step
+void Save_Position(Marble *marble) {
+    marble->prev_x = marble->x;
+    marble->prev_y = marble->y;
+}
+
+// Move the marble by an amount x,y
+void Move_Marble(Marble* marble, Fixed x, Fixed y) {
+    marble->x += x;
+    marble->y += y;
+}
+
+// Stop on a marble pool fault, where the debugger will find it
+void Pool_Fault() {
+    for(ever);
+}
+
+// Link every marble in the pool into the free list
+void Pool_Init() {
+    int i;
+    
+    pool_free = NULL;
+    for (i = MAX_MARBLES - 1; i >= 0; i--) {
+        marble_pool[i].next = pool_free;
+        pool_free = &marble_pool[i];
+    }
+    pool_used = 0;
+}
+
+// Take a marble from the pool in constant time
+// The screen holds far fewer marbles than the pool, so running out is a fault
+Marble_Handle Pool_Alloc() {
+    Marble *marble = pool_free;
+    int index;
+    
+    if (marble == NULL) {
+        Pool_Fault();
+    }
+    pool_free = marble->next;
+    marble->next = NULL;
+    
+    if (++pool_used > pool_high_water) {
+        pool_high_water = pool_used;
+    }
+    
+    index = marble - marble_pool;
+    return ((Marble_Handle)pool_generation[index] << 16) | (index + 1);
+}
+
+// Return a marble to the pool in constant time, invalidating its handles
+void Pool_Release(Marble *marble) {
+    pool_generation[marble - marble_pool]++;
+    marble->next = pool_free;
+    pool_free = marble;
+    pool_used--;
+}
+
+// Obtain the marble behind a handle
+Marble *Marble_Get(Marble_Handle handle) {
+    int index = (handle & 0xFFFF) - 1;
+    
+#ifdef DEBUG
+    // The marble was released since the handle was taken
+    if (index < 0 || index >= MAX_MARBLES || pool_generation[index] != (handle >> 16)) {
+        Pool_Fault();
+    }
+#endif
+    
+    return &marble_pool[index];
+}
+
+// Most marbles in use at once since start-up, for sizing MAX_MARBLES
+uint32_t Pool_High_Water() {
+    return pool_high_water;
+}
+
+// Obtain the primary colour code given a colour enum
+uint16_t Get_Primary_Hex(Colour named_colour) {
+    switch (named_colour) {
+        case WHITE: return HEX_WHITE_PRI;
+        case RED: return HEX_RED_PRI;
+        case BLUE: return HEX_BLUE_PRI;
+        case GREEN: return HEX_GREEN_PRI;
+        case YELLOW: return HEX_YELLOW_PRI;
+        case BLACK: return HEX_BLACK;
+        default: return HEX_INVALID; // Should never get here
+    }
+}
+
+// Obtain the marble sprite given a colour enum
+const uint16_t *Get_Sprite(Colour named_colour) {
+    switch (named_colour) {
+        case WHITE: return sprite_white;
+        case RED: return sprite_red;
+        case BLUE: return sprite_blue;
+        case GREEN: return sprite_green;
+        case YELLOW: return sprite_yellow;
+        case BLACK: return sprite_black;
+        default: return sprite_invalid; // Should never get here
+    }
+}
+
+// Index after the last marble of a segment
+int Segment_End(Train *t, int s) {
+    return (s + 1 < t->num_segments) ? t->segment[s + 1].first : t->length;
+}
+
+// Copy a marble into a snapshot
+void Snapshot_Copy(Snapshot_Marble *dest, Marble *marble) {
+    dest->x = FIXED_INT(marble->x);
+    dest->y = FIXED_INT(marble->y);
+    dest->prev_x = FIXED_INT(marble->prev_x);
+    dest->prev_y = FIXED_INT(marble->prev_y);
+    dest->colour = marble->colour;
+}
+
+// Publish the game state to the renderer, only done by the game logic
+// alpha is the time since the last simulation step, out of SIM_ALPHA_ONE
+void Publish_Snapshot(uint32_t alpha) {
+    Frame_Snapshot *snap = &snapshots[snapshot_back];
+    Snapshot_Marble *dest;
+    Train *t;
+    Segment *seg;
+    Fixed x, y;
+    int b, n, s, i;
+    
+    snap->state = state;
+    snap->alpha = alpha;
+    snap->cannon_angle = cannon_angle;
+    snap->chambered_colour = chambered_colour;
+    snap->spare_colour = spare_colour;
+    snap->num_bullets = 0;
+    for (b = 0; b < MAX_BULLETS; b++) {
+        if (bullets[b].marble) {
+            Snapshot_Copy(&snap->bullet[snap->num_bullets++], Marble_Get(bullets[b].marble));
+        }
+    }
+    
+    // Every train's marbles, one after another
+    snap->num_marbles = 0;
+    for (n = 0; n < NUM_TRAINS; n++) {
+        t = &trains[n];
+        for (s = 0; s < t->num_segments; s++) {
+            seg = &t->segment[s];
+            for (i = seg->first; i < Segment_End(t, s); i++) {
+                LOGIC_OPS(2); // Track lookups
+                dest = &snap->train[snap->num_marbles++];
+                Track_Point(t->track, ON_TRACK(t->track, seg->offset + TRAIN_SPAN(i - seg->first)), &x, &y);
+                dest->x = FIXED_INT(x);
+                dest->y = FIXED_INT(y);
+                Track_Point(t->track, ON_TRACK(t->track, seg->prev_offset + TRAIN_SPAN(i - seg->first)), &x, &y);
+                dest->prev_x = FIXED_INT(x);
+                dest->prev_y = FIXED_INT(y);
+                dest->colour = t->colour[i];
+            }
+        }
+    }
+    memcpy(snap->score_str, score_str, sizeof(snap->score_str));
+    
+    // Hand the filled buffer over and take back the one not being read
+    snapshot_back = HAL_Atomic_Swap(&snapshot_ready, snapshot_back | SNAPSHOT_FRESH) & ~SNAPSHOT_FRESH;
+    os_evt_set(EVT_LCD_FRAME, tsk_LCD);
+}
+
+// Position between the last two simulation steps
+int Interpolate(int16_t prev, int16_t cur, uint32_t alpha) {
+    return prev + (((cur - prev) * (int)alpha) / SIM_ALPHA_ONE);
+}
+
+// Obtain the latest game state, only done by the renderer
+// Returns the previous snapshot again if nothing new was published
+Frame_Snapshot *Acquire_Snapshot() {
+    if (snapshot_ready & SNAPSHOT_FRESH) {
+        snapshot_front = HAL_Atomic_Swap(&snapshot_ready, snapshot_front) & ~SNAPSHOT_FRESH;
+    }
+    
+    return &snapshots[snapshot_front];
+}
+
+// Add a marble centred at x,y to a sprite list
+void Add_Sprite(Sprite *list, int *num, int x, int y, Colour colour) {
+    if (*num < MAX_SPRITES) {
+        list[*num].x = x - MARBLE_DIAMETER / 2;
+        list[*num].y = y - MARBLE_DIAMETER / 2;
+        list[*num].image = Get_Sprite(colour);
+        (*num)++;
+    }
+}
+
+// Add the cannon sprites given its angle and the chambered and spare colours
+void Add_Cannon(Sprite *list, int *num, int angle, Colour chambered_colour, Colour spare_colour) {
+    // Used to position the cannon
+    Marble renderer;
+    Fixed cos_angle = Fixed_Cos(angle), sin_angle = Fixed_Sin(angle);
+    
+    // The chambered marble sits at the pivot
+    Position_Marble(&renderer, TO_FIXED(CANNON_X), TO_FIXED(CANNON_Y));
+    Add_Sprite(list, num, FIXED_INT(renderer.x), FIXED_INT(renderer.y), chambered_colour);
+
+    // The spare marble sits behind it, according to rotation
+    Move_Marble(&renderer, -16 * cos_angle, -16 * sin_angle);
+    Add_Sprite(list, num, FIXED_INT(renderer.x), FIXED_INT(renderer.y), spare_colour);
+
+    // The arm of the cannon points along its rotation
+    Move_Marble(&renderer, 32 * cos_angle, 32 * sin_angle);
+    Add_Sprite(list, num, FIXED_INT(renderer.x), FIXED_INT(renderer.y), CANNON_COLOUR);
+    Move_Marble(&renderer, 16 * cos_angle, 16 * sin_angle);
+    Add_Sprite(list, num, FIXED_INT(renderer.x), FIXED_INT(renderer.y), CANNON_COLOUR);
+}
+
+// Grow a rectangle to also cover another
+void Union_Rect(Rect *rect, Rect *other) {
+    if (other->x0 < rect->x0) rect->x0 = other->x0;
+    if (other->y0 < rect->y0) rect->y0 = other->y0;
+    if (other->x1 > rect->x1) rect->x1 = other->x1;
+    if (other->y1 > rect->y1) rect->y1 = other->y1;
+}
+
+// Check two rectangles for overlap
+bool Rect_Overlap(Rect *r1, Rect *r2) {
+    return (r1->x0 < r2->x1 && r2->x0 < r1->x1 && r1->y0 < r2->y1 && r2->y0 < r1->y1);
+}
+
+// Mark a screen area as needing a repaint, merging it with any damage it overlaps
+void Add_Damage(int x0, int y0, int x1, int y1) {
+    Rect rect = { x0, y0, x1, y1 };
+    int i = 0;
+
+    // Clip to the screen
+    if (rect.x0 < 0) rect.x0 = 0;
+    if (rect.y0 < 0) rect.y0 = 0;
+    if (rect.x1 > WINDOW_X) rect.x1 = WINDOW_X;
+    if (rect.y1 > WINDOW_Y) rect.y1 = WINDOW_Y;
+    if (rect.x0 >= rect.x1 || rect.y0 >= rect.y1) {
+        return;
+    }
+
+    // Make room by absorbing the last rectangle if the list is full
+    if (num_damage == MAX_DAMAGE) {
+        Union_Rect(&rect, &damage[--num_damage]);
+    }
+
+    // Absorb overlapping rectangles, restarting as the area grows
+    while (i < num_damage) {
+        if (Rect_Overlap(&rect, &damage[i])) {
+            Union_Rect(&rect, &damage[i]);
+            damage[i] = damage[--num_damage];
+            i = 0;
+        }
+        else {
+            i++;
+        }
+    }
+
+    damage[num_damage++] = rect;
+}
+
+// Damage the previous and new bounds of every sprite that changed between frames
+void Damage_Sprites(Sprite *prev, int num_prev, Sprite *cur, int num_cur) {
+    int i;
+
+    for (i = 0; i < num_prev || i < num_cur; i++) {
+        if (i < num_prev && i < num_cur && prev[i].x == cur[i].x &&
+            prev[i].y == cur[i].y && prev[i].image == cur[i].image) {
+            continue;
+        }
+        if (i < num_prev) {
+            Add_Damage(prev[i].x, prev[i].y, prev[i].x + MARBLE_DIAMETER, prev[i].y + MARBLE_DIAMETER);
+        }
+        if (i < num_cur) {
+            Add_Damage(cur[i].x, cur[i].y, cur[i].x + MARBLE_DIAMETER, cur[i].y + MARBLE_DIAMETER);
+        }
+    }
+}
+
+// Compose the w by h screen area at x,y into a bitmap, bottom row first as GLCD_Bitmap expects
+// Sprites are painted in order, later sprites on top, then the text on top of them
+void Compose_Strip(uint16_t *bmp, int x, int y, int w, int h, Sprite *list, int num,
+                   int text_x, int text_y, char *text) {
+    int i, j, row, col, row_end, col_start, col_end;
+    uint16_t pixs, *line;
+    const uint16_t *image;
+
+    // Start from the background
+    for (i = 0; i < w * h; i++) {
+        bmp[i] = Get_Primary_Hex(BACKGROUND_COLOUR);
+    }
+
+    // Paint each overlapping sprite
+    // Rows and columns are clipped in screen coordinates, both pointers stay at a row start
+    for (i = 0; i < num; i++) {
+        row = list[i].y > y ? list[i].y : y;
+        row_end = list[i].y + MARBLE_DIAMETER < y + h ? list[i].y + MARBLE_DIAMETER : y + h;
+        col_start = list[i].x > x ? list[i].x : x;
+        col_end = list[i].x + MARBLE_DIAMETER < x + w ? list[i].x + MARBLE_DIAMETER : x + w;
+        if (row >= row_end || col_start >= col_end) {
+            continue;
+        }
+
+        for (; row < row_end; row++) {
+            image = &list[i].image[(row - list[i].y) * MARBLE_DIAMETER];
+            line = &bmp[(y + h - 1 - row) * w];
+            for (col = col_start; col < col_end; col++) {
+                if (image[col - list[i].x] != SPRITE_CLEAR) {
+                    line[col - x] = image[col - list[i].x];
+                }
+            }
+        }
+    }
+
+    // Paint the overlapping rows of the text, glyphs are opaque
+    row = text_y > y ? text_y : y;
+    row_end = text_y + FONT_H < y + h ? text_y + FONT_H : y + h;
+    for (j = 0; text[j] != '\0'; j++, text_x += FONT_W) {
+        col_start = text_x > x ? text_x : x;
+        col_end = text_x + FONT_W < x + w ? text_x + FONT_W : x + w;
+        for (i = row; i < row_end; i++) {
+            pixs = ((unsigned short *)GLCD_CharBitmap(1, text[j]))[i - text_y];
+            line = &bmp[(y + h - 1 - i) * w];
+            for (col = col_start; col < col_end; col++) {
+                line[col - x] = (pixs >> (col - text_x)) & 1 ? Get_Primary_Hex(TEXT_COLOUR) : Get_Primary_Hex(BACKGROUND_COLOUR);
+            }
+        }
+    }
+}
+
+// Replay the display list to the screen, only done by the LCD task
+// Returns true if the screen was cleared
+bool LCD_Replay() {
+    unsigned int pending;
+    
+    // Hand over the commands recorded so far
+    os_mut_wait(&mut_list, 0xFFFF); // -----------------------------------------
+    pending = GLCD_List_Pending();
+    os_mut_release(&mut_list); // ----------------------------------------------
+    
+    return (GLCD_List_Replay(pending) > 0);
+}
+
+// Record a bitmap in the display list and replay it, only done by the LCD task
+// A full list is replayed to make room first, the bitmap is dropped if that cleared the screen
+// Once the game is over the bitmap is dropped too, as it would land after the end screen's clear
+// The game logic leaves GAME_ON before recording that clear, so checking under the lock is enough
+// Returns true if the screen was cleared by a command recorded before it, or is about to be
+bool LCD_Submit_Bitmap(int x, int y, int w, int h, uint16_t *bmp) {
+    int added;
+    
+    for(ever) {
+        os_mut_wait(&mut_list, 0xFFFF); // -------------------------------------
+        if (state != GAME_ON) {
+            os_mut_release(&mut_list); // --------------------------------------
+            return true;
+        }
+        added = GLCD_Cmd_Bitmap(x, y, w, h, bmp);
+        os_mut_release(&mut_list); // ------------------------------------------
+        
+        if (added) {
+            return LCD_Replay();
+        }
+        if (LCD_Replay()) {
+            return true;
+        }
+    }
+}
+
+// Record the title screen in the display list
+void Record_Title_Screen() {
+    os_mut_wait(&mut_list, 0xFFFF); // -----------------------------------------
+    GLCD_Cmd_Text(5, 1, 1, TEXT_COLOUR, BACKGROUND_COLOUR, title_str);
+    GLCD_Cmd_Text(20, 10, 0, TEXT_COLOUR, BACKGROUND_COLOUR, inst_str);
+    os_mut_release(&mut_list); // ----------------------------------------------
+    os_evt_set(EVT_LCD_FRAME, tsk_LCD);
+}
+
+// Record a cleared game screen in the display list
+void Record_Game_Screen() {
+    os_mut_wait(&mut_list, 0xFFFF); // -----------------------------------------
+    GLCD_Cmd_Clear(BACKGROUND_COLOUR);
+    os_mut_release(&mut_list); // ----------------------------------------------
+    os_evt_set(EVT_LCD_FRAME, tsk_LCD);
+}
+
+// Record the victory or loss screen with the final score in the display list
+void Record_End_Screen(bool won) {
+    os_mut_wait(&mut_list, 0xFFFF); // -----------------------------------------
+    GLCD_Cmd_Clear(BACKGROUND_COLOUR);
+    if (won) {
+        GLCD_Cmd_Text(5, 4, 1, TEXT_COLOUR, BACKGROUND_COLOUR, gg_win_str);
+    }
+    else {
+        GLCD_Cmd_Text(5, 3, 1, TEXT_COLOUR, BACKGROUND_COLOUR, gg_lose_str);
+    }
+    GLCD_Cmd_Text(7, 3, 1, TEXT_COLOUR, BACKGROUND_COLOUR, gg_score_str);
+    GLCD_Cmd_Text(7, 10, 1, TEXT_COLOUR, BACKGROUND_COLOUR, score_str);
+    os_mut_release(&mut_list); // ----------------------------------------------
+    os_evt_set(EVT_LCD_FRAME, tsk_LCD);
+}
+
+// Repaint every strip touched by damage from the sprite list and score, one window per strip
+// Only the columns spanned by the strip's damage are composed and pushed
+// Returns true if the screen was cleared by a command recorded meanwhile
+bool Render_Strips(Sprite *list, int num, char *score_text) {
+    int strip, i, x0, x1, y0, h;
+    bool cleared = false;
+
+    // Stop if the screen is cleared, the next frame is drawn in full
+    for (strip = 0; strip < NUM_STRIPS && !cleared; strip++) {
+        y0 = strip * STRIP_HEIGHT;
+        h = y0 + STRIP_HEIGHT < WINDOW_Y ? STRIP_HEIGHT : WINDOW_Y - y0;
+
+        // Find the columns damaged within the strip
+        x0 = WINDOW_X;
+        x1 = 0;
+        for (i = 0; i < num_damage; i++) {
+            if (damage[i].y0 < y0 + h && y0 < damage[i].y1) {
+                if (damage[i].x0 < x0) x0 = damage[i].x0;
+                if (damage[i].x1 > x1) x1 = damage[i].x1;
+            }
+        }
+        
+        // Skip unchanged strips
+        if (x0 >= x1) {
+            continue;
+        }
+
+        // The other buffer may still be streaming out, even the last one of the previous frame
+        strip_buf ^= 1;
+        Compose_Strip(strip_bmp[strip_buf], x0, y0, x1 - x0, h, list, num, SCORE_X, SCORE_Y, score_text);
+        cleared |= LCD_Submit_Bitmap(x0, y0, x1 - x0, h, strip_bmp[strip_buf]);
+        frame_pixels += (x1 - x0) * h;
+    }
+    
+    return cleared;
+}
+
+// Draw a game snapshot as sprite list cur, repainting only what moved since the other list
+// drawn_score is the score on screen, SCORE_DIGITS + 1 characters, replaced once it is redrawn
+// Returns true if the screen was cleared by a command recorded meanwhile
+bool Render_Frame(Frame_Snapshot *snap, int cur, char *drawn_score) {
+    int i, score_len = 0;
+    
+    num_sprites[cur] = 0;
+    
+    // Trains, then the cannon, then the bullets on top
+    for (i = 0; i < snap->num_marbles; i++) {
+        Add_Sprite(sprites[cur], &num_sprites[cur],
+                   Interpolate(snap->train[i].prev_x, snap->train[i].x, snap->alpha),
+                   Interpolate(snap->train[i].prev_y, snap->train[i].y, snap->alpha),
+                   snap->train[i].colour);
+    }
+    Add_Cannon(sprites[cur], &num_sprites[cur], snap->cannon_angle, snap->chambered_colour, snap->spare_colour);
+    for (i = 0; i < snap->num_bullets; i++) {
+        Add_Sprite(sprites[cur], &num_sprites[cur],
+                   Interpolate(snap->bullet[i].prev_x, snap->bullet[i].x, snap->alpha),
+                   Interpolate(snap->bullet[i].prev_y, snap->bullet[i].y, snap->alpha),
+                   snap->bullet[i].colour);
+    }
+    
+    // A new score repaints as many characters as the longer of it and the old one
+    if (strcmp(drawn_score, snap->score_str) != 0) {
+        score_len = (int)strlen(drawn_score);
+        if ((int)strlen(snap->score_str) > score_len) {
+            score_len = (int)strlen(snap->score_str);
+        }
+        strcpy(drawn_score, snap->score_str);
+    }
+    
+    // Repaint only what moved since the previous frame
+    num_damage = 0;
+    frame_pixels = 0;
+    Damage_Sprites(sprites[cur ^ 1], num_sprites[cur ^ 1], sprites[cur], num_sprites[cur]);
+    if (score_len > 0) {
+        Add_Damage(SCORE_X, SCORE_Y, SCORE_X + score_len * FONT_W, SCORE_Y + SCORE_H);
+    }
+    return Render_Strips(sprites[cur], num_sprites[cur], drawn_score);
+}
+
+// Sweep a marble centre from x,y by step_x,step_y against a still one at train_x,train_y
+// Solves |start + toi * step - train|^2 = COLLIDE_DIST^2 for the first contact, in 64 bits
+// Pairs further apart than the step can close are rejected before any multiply
+// Returns whether they touch during the step, setting toi to when as a Q16.16 fraction of it
+bool Sweep_Collision(Fixed x, Fixed y, Fixed step_x, Fixed step_y, Fixed train_x, Fixed train_y,
+                     uint32_t *toi) {
+    int32_t fx, fy, sx, sy, reach;
+    int64_t a, b, c, disc;
+    
+    sx = step_x >> COLLIDE_SHIFT;
+    sy = step_y >> COLLIDE_SHIFT;
+    reach = COLLIDE_DIST + abs(sx) + abs(sy);
+    
+    fy = (y - train_y) >> COLLIDE_SHIFT;
+    if (fy >= reach || fy <= -reach) {
+        return false;
+    }
+    
+    fx = (x - train_x) >> COLLIDE_SHIFT;
+    if (fx >= reach || fx <= -reach) {
+        return false;
+    }
+    
+    // Already touching at the start of the step
+    c = (int64_t)fx * fx + (int64_t)fy * fy - SQUARE(COLLIDE_DIST);
+    if (c < 0) {
+        *toi = 0;
+        return true;
+    }
+    
+    // Not closing, or passing wide
+    b = (int64_t)fx * sx + (int64_t)fy * sy;
+    if (b >= 0) {
+        return false;
+    }
+    a = (int64_t)sx * sx + (int64_t)sy * sy;
+    disc = b * b - a * c;
+    if (disc < 0) {
+        return false;
+    }
+    
+    // Earlier root, contact after the step is left to the next one
+    *toi = (uint32_t)(((-b - Fixed_Isqrt(disc)) << FIXED_SHIFT) / a);
+    return (*toi <= FIXED_ONE);
+}
+
+// Find the segment holding a train marble, a binary search over the segments
+int Train_Segment_Of(Train *t, int index) {
+    int low = 0, high = t->num_segments - 1, mid;
+    
+    while (low < high) {
+        mid = (low + high + 1) / 2;
+        if (t->segment[mid].first <= index) {
+            low = mid;
+        }
+        else {
+            high = mid - 1;
+        }
+    }
+    return low;
+}
+
+// Distance of a train marble along the track
+Distance Train_Distance(Train *t, int index) {
+    Segment *seg = &t->segment[Train_Segment_Of(t, index)];
+    
+    return seg->offset + TRAIN_SPAN(index - seg->first);
+}
+
+// Check two neighbouring train marbles for contact, true unless a segment starts between them
+bool Train_Contact(Train *t, int i) {
+    return (i + 1 < t->length && t->segment[Train_Segment_Of(t, i + 1)].first != i + 1);
+}
+
+// Sweep one marble along a step against every train marble near its path
+// The track's cell table gives the distances along it that pass near the path, and only the
+// few marbles within that range are tested, so a query costs the same on any train length
+// Segments lie in order along the track, at least a marble apart, so those before the range
+// are skipped by a binary search and the ones after it by stopping there
+// The train moves well under a pixel a step and is taken as still during it
+// Returns the index of the marble hit earliest, the first in train order on a tie, or -1
+int Train_Sweep(Train *t, Marble *marble, Fixed step_x, Fixed step_y, uint32_t *toi) {
+    Fixed x = marble->x, y = marble->y, near_min, near_max, train_x, train_y;
+    Segment *seg;
+    uint32_t hit_toi;
+    int s, k, low, high, hit = -1;
+    
+    if (!Track_Near(t->track, x, y, x + step_x, y + step_y, &near_min, &near_max)) {
+        return -1;
+    }
+    
+    // Last segment starting at or before near_min, the earlier ones end short of it
+    low = 0;
+    high = t->num_segments - 1;
+    while (low < high) {
+        s = (low + high + 1) / 2;
+        if (t->segment[s].offset <= near_min) {
+            low = s;
+        }
+        else {
+            high = s - 1;
+        }
+    }
+    
+    // Up to the first segment that starts a spacing or more past near_max
+    for (s = low; s < t->num_segments && t->segment[s].offset < near_max + MARBLE_SPACING; s++) {
+        seg = &t->segment[s];
+        
+        // Marbles of the segment between near_min and near_max
+        low = (near_min - seg->offset) / MARBLE_SPACING;
+        high = (near_max - seg->offset) / MARBLE_SPACING + 1;
+        if (low < 0) {
+            low = 0;
+        }
+        if (high > Segment_End(t, s) - seg->first) {
+            high = Segment_End(t, s) - seg->first;
+        }
+        
+        for (k = low; k < high; k++) {
+            LOGIC_OPS(1); // Track lookup and collision test
+            Track_Point(t->track, ON_TRACK(t->track, seg->offset + TRAIN_SPAN(k)), &train_x, &train_y);
+            if (Sweep_Collision(x, y, step_x, step_y, train_x, train_y, &hit_toi) &&
+                (hit < 0 || hit_toi < *toi)) {
+                hit = seg->first + k;
+                *toi = hit_toi;
+            }
+        }
+    }
+    
+    return hit;
+}
+
+// Insert a marble into segment s of the train before index, moving the rest up in bulk
+// The marbles of the segment from index on move forward a place
+// Returns false if the train is full
+bool Train_Insert(Train *t, int s, int index, Colour colour) {
+    int move = t->length - index;
+    
+    if (t->length >= MAX_TRAIN) {
+        return false;
+    }
+    
+    LOGIC_OPS(move); // Marbles shifted
+    memmove(&t->colour[index + 1], &t->colour[index], move * sizeof(t->colour[0]));
+    memmove(&t->run_back[index + 1], &t->run_back[index], move * sizeof(t->run_back[0]));
+    memmove(&t->run_ahead[index + 1], &t->run_ahead[index], move * sizeof(t->run_ahead[0]));
+    
+    t->colour[index] = colour;
+    t->run_back[index] = 0; // Recounted once the marble is in place
+    t->run_ahead[index] = 0;
+    
+    for (s++; s < t->num_segments; s++) {
+        t->segment[s].first++;
+    }
+    
+    if ((uint32_t)++t->length > train_high_water) {
+        train_high_water = t->length;
+    }
+    return true;
+}
+
+// Remove count marbles from the train starting at index, moving the rest down in bulk
+// The marbles left on either side keep their positions, splitting a segment if needed
+void Train_Remove(Train *t, int index, int count) {
+    int end = index + count, move = t->length - end, s, w = 0, seg_end;
+    Segment seg;
+    
+    // Room for one segment to split in two, segments are then rewritten front to back
+    memmove(&t->segment[1], &t->segment[0], t->num_segments * sizeof(t->segment[0]));
+    for (s = 1; s <= t->num_segments; s++) {
+        seg = t->segment[s];
+        seg_end = (s < t->num_segments) ? t->segment[s + 1].first : t->length;
+        
+        if (seg_end <= index || seg.first >= end) {
+            // Untouched
+            if (seg.first >= end) {
+                seg.first -= count;
+            }
+            t->segment[w++] = seg;
+        }
+        else {
+            // Marbles before the removed ones
+            if (seg.first < index) {
+                t->segment[w++] = seg;
+            }
+            
+            // Marbles after the removed ones
+            if (seg_end > end) {
+                t->segment[w].first = index;
+                t->segment[w].offset = seg.offset + TRAIN_SPAN(end - seg.first);
+                t->segment[w].prev_offset = seg.prev_offset + TRAIN_SPAN(end - seg.first);
+                w++;
+            }
+        }
+    }
+    t->num_segments = w;
+    
+    LOGIC_OPS(move + t->num_segments); // Marbles shifted, segments rewritten
+    memmove(&t->colour[index], &t->colour[end], move * sizeof(t->colour[0]));
+    memmove(&t->run_back[index], &t->run_back[end], move * sizeof(t->run_back[0]));
+    memmove(&t->run_ahead[index], &t->run_ahead[end], move * sizeof(t->run_ahead[0]));
+    
+    t->length -= count;
+}
+
+// Recount the run of same coloured marbles in contact around a marble, in the run's length
+// Returns the index of the last marble in the run
+int Train_Rescan_Run(Train *t, int index) {
+    int first = index, last = index, i;
+    
+    while (first > 0 && t->colour[first - 1] == t->colour[index] && Train_Contact(t, first - 1)) {
+        first--;
+    }
+    while (last + 1 < t->length && t->colour[last + 1] == t->colour[index] && Train_Contact(t, last)) {
+        last++;
+    }
+    
+    LOGIC_OPS(last - first + 1); // Marbles recounted
+    for (i = first; i <= last; i++) {
+        t->run_back[i] = i - first;
+        t->run_ahead[i] = last - i;
+    }
+    return last;
+}
+
+// Merge every segment that touches the one behind it, the rear one pushing it into place
+void Train_Join_Segments(Train *t) {
+    Segment *seg;
+    Distance tail;
+    int s = 0, boundary;
+    
+    while (s + 1 < t->num_segments) {
+        seg = &t->segment[s];
+        boundary = t->segment[s + 1].first;
+        tail = seg->offset + TRAIN_SPAN(boundary - 1 - seg->first);
+        
+        if (t->segment[s + 1].offset - tail < TO_FIXED(MARBLE_DIAMETER)) {
+            // In collision, the marbles ahead join the segment at its spacing
+            memmove(&t->segment[s + 1], &t->segment[s + 2], (t->num_segments - s - 2) * sizeof(t->segment[0]));
+            t->num_segments--;
+            
+            // Closing a gap can join two runs of the same colour
+            if (t->colour[boundary - 1] == t->colour[boundary]) {
+                Train_Rescan_Run(t, boundary);
+            }
+        }
+        else {
+            s++;
+        }
+    }
+}
+
+// Remember the segment positions as the start of the next simulation step
+void Train_Save_Positions(Train *t) {
+    int s;
+    
+    for (s = 0; s < t->num_segments; s++) {
+        t->segment[s].prev_offset = t->segment[s].offset;
+    }
+}
+
+// Move the train one step, one add per segment
+// The rear segment moves forward, segments ahead of a gap with the same colour either side are
+// drawn back to it, and any others wait to be pushed
+void Move_Marble_Train(Train *t, Fixed distance) {
+    int s;
+    
+    LOGIC_OPS(t->num_segments); // Segments moved
+    t->segment[0].offset += distance;
+    for (s = 1; s < t->num_segments; s++) {
+        if (t->colour[t->segment[s].first - 1] == t->colour[t->segment[s].first]) {
+            t->segment[s].offset -= RETRACT_STEP;
+        }
+    }
+    
+    Train_Join_Segments(t);
+}
+
+// Place a bullet into the train at a hit found by Train_Sweep, setting its train index
+// The bullet first moves up to the point of impact, the side is then where it lies along the
+// track's direction
+// Returns whether the bullet joined the train, or was lost to a full train
+Bullet_Result Bullet_Join(Bullet *b, Train *t, int current, uint32_t toi, int *index) {
+    Marble *bullet_ptr = Marble_Get(b->marble);
+    Fixed train_x, train_y;
+    int track_dx, track_dy;
+    
+    Move_Marble(bullet_ptr, FIXED_MUL(b->step_x, toi), FIXED_MUL(b->step_y, toi));
+    Track_Point(t->track, ON_TRACK(t->track, Train_Distance(t, current)), &train_x, &train_y);
+    Track_Direction(t->track, ON_TRACK(t->track, Train_Distance(t, current)), &track_dx, &track_dy);
+    if ((bullet_ptr->x - train_x) * track_dx + (bullet_ptr->y - train_y) * track_dy < 0) {
+        // Bullet made a collision from behind
+        // The bullet takes the marble's place and the marble moves forward
+        *index = current;
+    }
+    else {
+        // Bullet made a collision from ahead
+        // The bullet goes in after the marble
+        *index = current + 1;
+    }
+    
+    // The marbles ahead in the segment move forward, which may reach the next segment
+    if (!Train_Insert(t, Train_Segment_Of(t, current), *index, bullet_ptr->colour)) {
+        return BULLET_LOST;
+    }
+    Train_Join_Segments(t);
+    
+    // Recount the run the bullet joined and any it split
+    if (*index > 0) {
+        Train_Rescan_Run(t, *index - 1);
+    }
+    Train_Rescan_Run(t, *index);
+    if (*index + 1 < t->length) {
+        Train_Rescan_Run(t, *index + 1);
+    }
+
+    return BULLET_JOINED;
+}
+
+// Move a bullet that hit nothing through its whole step
+// Returns whether the bullet is still flying or left the screen
+Bullet_Result Move_Bullet(Bullet *b) {
+    Marble *bullet_ptr = Marble_Get(b->marble);
+    
+    // Move the marble in its flight vector
+    Move_Marble(bullet_ptr, b->step_x, b->step_y);
+
+    // Ensure marble is within screen boundaries
+    if (bullet_ptr->x >= TO_FIXED(WINDOW_X - MARBLE_DIAMETER) || bullet_ptr->x <= TO_FIXED(0 + MARBLE_DIAMETER) ||
+        bullet_ptr->y >= TO_FIXED(WINDOW_Y - MARBLE_DIAMETER) || bullet_ptr->y <= TO_FIXED(0 + MARBLE_DIAMETER)) {
+        return BULLET_LOST;
+    }
+
+    return BULLET_FLYING;
+}
+
+// Eliminate the bullet's run if it is long enough, then keep eliminating while the runs
+// either side of the gap share a colour and are long enough together (a chain reaction)
+// Only the runs next to the gap are looked at, never the whole train
+// Returns the combo depth, the number of runs collapsed
+int Collapse_Marbles(Train *t, int bullet_index) {
+    int first = bullet_index - t->run_back[bullet_index];
+    int last = bullet_index + t->run_ahead[bullet_index];
+    int depth = 0;
+    
+    while (last - first + 1 >= 3) {
+        // Collapse
+        Train_Remove(t, first, last - first + 1);
+        depth++;
+        
+        // Merge the runs now either side of the gap, or exit
+        if (first == 0 || first >= t->length || t->colour[first - 1] != t->colour[first]) {
+            break;
+        }
+        last = first + t->run_ahead[first];
+        first = first - 1 - t->run_back[first - 1];
+    }
+    
+    return depth;
+}
+
+// Convert a potentiometer reading to a cannon angle in degrees, truncated towards zero
+int Pot_To_Angle(uint32_t reading) {
+    return ((int)(POT_MAX - reading) * 8 - MAX_CANNON_ANGLE * POT_PER_DEGREE_X8) / POT_PER_DEGREE_X8;
+}
+
+// Generate a random number given a seed
+uint16_t Random_Number() {
+    bit  = ((seed >> 0) ^ (seed >> 2) ^ (seed >> 3) ^ (seed >> 5) ) & 1;
+    return seed = (seed >> 1) | (bit << 15);
+}
+
+// Generate a random colour
+Colour Generate_Colour() {
+    switch (Random_Number() % 4) {
+        case 0: return RED;
+        case 1: return BLUE;
+        case 2: return GREEN;
+        case 3: return YELLOW;
+        default: return MAGENTA; // Should never get here
+    }
+}
+
+// Update the score multiplier, waking the LED task only if it changed
+void Set_Multiplier(uint32_t multiplier) {
+    if (multiplier != score_multiplier) {
+        os_mut_wait(&mut_LED, 0xFFFF); // --------------------------------------
+        score_multiplier = multiplier;
+        os_mut_release(&mut_LED); // -------------------------------------------
+        os_evt_set(EVT_LED_UPDATE, tsk_LED);
+    }
+}
+
+// Sweep every airborne bullet against every train, before any train changes
+// Each bullet keeps its earliest hit, the lower train on a tie
+// Returns the number of hits, ordered by time of impact and then bullet slot
+int Sweep_Bullets(Pending_Hit *hits) {
+    Pending_Hit hit;
+    uint32_t toi;
+    int b, n, current, num_hits = 0, i;
+    
+    for (b = 0; b < MAX_BULLETS; b++) {
+        if (!bullets[b].marble) {
+            continue;
+        }
+        
+        hit.train = -1;
+        for (n = 0; n < NUM_TRAINS; n++) {
+            current = Train_Sweep(&trains[n], Marble_Get(bullets[b].marble), bullets[b].step_x, bullets[b].step_y, &toi);
+            if (current >= 0 && (hit.train < 0 || toi < hit.toi)) {
+                hit.bullet = b;
+                hit.train = n;
+                hit.index = current;
+                hit.toi = toi;
+            }
+        }
+        
+        // Insertion sort, slots are visited in order so equal times keep slot order
+        if (hit.train >= 0) {
+            for (i = num_hits++; i > 0 && hits[i - 1].toi > hit.toi; i--) {
+                hits[i] = hits[i - 1];
+            }
+            hits[i] = hit;
+        }
+    }
+    
+    return num_hits;
+}
+
+// Score a bullet joining a train, collapsing the marbles around it
+void Score_Join(Train *t, int bullet_index) {
+    int combo, i;
+    
+    // Check and conditionally collapse the marbles around the bullet
+    combo = Collapse_Marbles(t, bullet_index);
+    if (combo > 0) {
+        // Gain ponits upon successful collapse
+        // Each run in a chain reaction scores at the next multiplier up
+        for (i = 1; i <= combo; i++) {
+            score += 10 * (score_multiplier + i);
+        }
+        Set_Multiplier(score_multiplier + combo);
+        snprintf(score_str, sizeof(score_str), "%03u", (unsigned int)score);
+    }
+    else {
+        // Lose multiplier
+        Set_Multiplier(0);
+    }
+}
+
+// Move every airborne bullet one step as one batched collision pass
+// All bullets are swept before any hit is applied, then the hits are applied earliest first,
+// so the outcome never depends on the order the bullets were fired in
+// A train takes one bullet a step, a later hit on it holds that bullet still to sweep again
+// against the changed train next step
+void Step_Bullets() {
+    Pending_Hit hits[MAX_BULLETS];
+    bool train_changed[NUM_TRAINS] = { false }, bullet_hit[MAX_BULLETS] = { false };
+    Bullet_Result result;
+    int num_hits, b, i, bullet_index;
+    
+    num_hits = Sweep_Bullets(hits);
+    for (i = 0; i < num_hits; i++) {
+        b = hits[i].bullet;
+        bullet_hit[b] = true;
+        if (train_changed[hits[i].train]) {
+            continue;
+        }
+        train_changed[hits[i].train] = true;
+        
+        result = Bullet_Join(&bullets[b], &trains[hits[i].train], hits[i].index, hits[i].toi, &bullet_index);
+        if (result == BULLET_JOINED) {
+            Score_Join(&trains[hits[i].train], bullet_index);
+        }
+        else {
+            // Train full, lose multiplier
+            Set_Multiplier(0);
+        }
+        
+        // The train holds its own copy of a joined bullet
+        Pool_Release(Marble_Get(bullets[b].marble));
+        bullets[b].marble = 0;
+    }
+    
+    // The bullets that hit nothing fly on
+    for (b = 0; b < MAX_BULLETS; b++) {
+        if (bullets[b].marble && !bullet_hit[b] && Move_Bullet(&bullets[b]) == BULLET_LOST) {
+            // Bullet left the screen, lose multiplier
+            Set_Multiplier(0);
+            Pool_Release(Marble_Get(bullets[b].marble));
+            bullets[b].marble = 0;
+        }
+    }
+}
+
+// Fire the chambered marble from the cannon into a free bullet slot
+// Returns false if every slot is in flight
+bool Fire_Bullet(int angle) {
+    Marble *marble;
+    int b;
+    
+    for (b = 0; b < MAX_BULLETS && bullets[b].marble; b++);
+    if (b == MAX_BULLETS) {
+        return false;
+    }
+    
+    bullets[b].marble = Pool_Alloc();
+    bullets[b].step_x = FIXED_MUL(BULLET_STEP, Fixed_Cos(angle));
+    bullets[b].step_y = FIXED_MUL(BULLET_STEP, Fixed_Sin(angle));
+    marble = Marble_Get(bullets[b].marble);
+    marble->colour = chambered_colour;
+    Position_Marble(marble, TO_FIXED(CANNON_X), TO_FIXED(CANNON_Y));
+    Save_Position(marble);
+    return true;
+}
+
+// Generate a train of starting marbles on a track, each in contact with the one before
+void Train_Start(Train *t, const Track *track) {
+    int i;
+    
+    t->track = track;
+    t->length = NUM_STARTING_MARBLES;
+    t->num_segments = 1;
+    t->segment[0].first = 0;
+    t->segment[0].offset = t->segment[0].prev_offset = TO_FIXED(MARBLE_DIAMETER);
+    for (i = 0; i < NUM_STARTING_MARBLES; i++) {
+        t->colour[i] = Generate_Colour();
+    }
+    for (i = 0; i < NUM_STARTING_MARBLES; i = Train_Rescan_Run(t, i) + 1);
+}
+
+// Signal the LCD task that a background pixel burst finished (called from the DMA ISR)
+void LCD_Burst_Done() {
+    isr_evt_set(EVT_LCD_DMA, tsk_LCD);
+}
+
+// Sleep until a background pixel burst finishes so other tasks can run meanwhile
+void LCD_Burst_Wait() {
+    uint32_t start = HAL_Cycles();
+    
+    os_evt_wait_or(EVT_LCD_DMA, 0xFFFF);
+    lcd_wait_cycles += HAL_Cycles() - start;
+}
+
+// ISRs ----------------------------------------------------------------------------------------------------------------
+// Press button, called from the button ISR
+void Button_Pressed() {
+    if (state == TITLE_SCREEN) {
+        // Start game
+        state = GAME_ON;
+        if (tsk_game) {
+            isr_evt_set(EVT_GAME_START, tsk_game);
+        }
+    }
+    else {
+        // Fire marble
+        shoot_marble = true;
+    }
+}
+
+// Tasks ---------------------------------------------------------------------------------------------------------------
+// Potentiometer read task
+__task void Potentiometer_Read() {
+    uint32_t reading = 0;
+    
+    // Initialize potentiometer and ADC converter
+    HAL_Pot_Init();
+    
+    // Periodically read and store the potentiometer value
+    os_itv_set(INPUT_INTERVAL);
+    for(ever) {
+        // Take a new reading
+        reading = HAL_Pot_Read();
+        
+        // Store in global variable
+        os_mut_wait(&mut_pot, 0xFFFF); // --------------------------------------
+        pot_position = reading;
+        os_mut_release(&mut_pot); // -------------------------------------------
+        
+        os_itv_wait();
+    }
+}
+
+// Joystick read task
+__task void Joystick_Read() {
+    bool joystick_prev_held = false;
+    
+    // Initialize joystick
+    HAL_Joystick_Init();
+    
+    // Periodically check the joystick status and set a flag if it is moved in
+    os_itv_set(INPUT_INTERVAL);
+    for(ever) {
+        // Set the flag once each time the joystick is held
+        if (HAL_Joystick_Held()) {
+            if (!joystick_prev_held) {
+                // Store in global variables
+                os_mut_wait(&mut_joy, 0xFFFF); // ------------------------------
+                swap_marble = true;
+                os_mut_release(&mut_joy); // -----------------------------------
+            }
+            joystick_prev_held = true;
+        }
+        else {
+            joystick_prev_held = false;
+        }
+        
+        os_itv_wait();
+    }
+}
+
+// Game logic handling task
+__task void Game_Logic() {
+    int n, b;
+    int temp_angle = 0, swap, shoot;
+    uint32_t prev_us, now_us, elapsed_us, accumulator_us = 0, replay_length, start;
+    const uint8_t *replay_log;
+    bool cleared, replaying;
+    Colour temp_colour;
+    
+    // Initialize timer
+    HAL_Timer_Init();
+    
+    // Wait while the game starts
+    Record_Title_Screen();
+    while (state == TITLE_SCREEN) {
+        os_evt_wait_or(EVT_GAME_START, 0xFFFF);
+    }
+    Record_Game_Screen();
+    
+    // Generate random seed given the start time
+    // Should be random due to the human factor
+    seed = HAL_Timer_Read();
+    
+    // Replay a recorded session from its own seed, or record this one if built to
+    // Without REPLAY_RECORD the recorder's calls compile to nothing
+    replay_log = HAL_Replay_Source(&replay_length);
+    replaying = Replay_Play_Start(replay_log, replay_length, &seed);
+    if (!replaying) {
+        Replay_Record_Start(seed);
+    }
+    
+    // Set the score in the display string
+    snprintf(score_str, sizeof(score_str), "%03u", (unsigned int)score);
+    
+    // Initialize the bullet marbles, none in flight
+    Pool_Init();
+    
+    // Generate the chambered and spare colours
+    chambered_colour = Generate_Colour();
+    spare_colour = Generate_Colour();
+    
+    // Generate the marble trains from the root down
+    for (n = 0; n < NUM_TRAINS; n++) {
+        Train_Start(&trains[n], level_tracks[n]);
+    }
+    
+    // Clear a button press bug and start the clock
+    shoot_marble = false;
+    prev_us = HAL_Timer_Read();
+            
+    // Game loop
+    while (state == GAME_ON) {
+        start = HAL_Cycles();
+        
+        // Accumulate the elapsed time, the unsigned difference survives the timer wrapping
+        now_us = HAL_Timer_Read();
+        elapsed_us = now_us - prev_us;
+        prev_us = now_us;
+        
+        // A replay supplies its recorded time instead, and goes live where the log ends
+        if (replaying) {
+            replaying = Replay_Play_Frame(&elapsed_us);
+        }
+        if (!replaying) {
+            Replay_Record_Frame(elapsed_us);
+        }
+        accumulator_us += elapsed_us;
+            
+        // Drop time the simulation cannot catch up on rather than spiralling
+        if (accumulator_us > MAX_SIM_STEPS * SIM_STEP_US) {
+            accumulator_us = MAX_SIM_STEPS * SIM_STEP_US;
+        }
+            
+        // Advance the simulation in fixed steps, independent of how long rendering took
+        while (accumulator_us >= SIM_STEP_US && state == GAME_ON) {
+            accumulator_us -= SIM_STEP_US;
+            
+            // Positions at the start of the step, for the renderer to interpolate from
+            for (n = 0; n < NUM_TRAINS; n++) {
+                Train_Save_Positions(&trains[n]);
+            }
+            for (b = 0; b < MAX_BULLETS; b++) {
+                if (bullets[b].marble) {
+                    Save_Position(Marble_Get(bullets[b].marble));
+                }
+            }
+            
+            // Read the potentiometer position and convert to angle
+            os_mut_wait(&mut_pot, 0xFFFF); // ----------------------------------
+            temp_angle = Pot_To_Angle(pot_position);
+            os_mut_release(&mut_pot); // ---------------------------------------
+            
+            // Take the joystick and button flags
+            os_mut_wait(&mut_joy, 0xFFFF); // ----------------------------------
+            swap = swap_marble;
+            swap_marble = false;
+            os_mut_release(&mut_joy); // ---------------------------------------
+            shoot = shoot_marble;
+            shoot_marble = false;
+            
+            // Every input the step takes is logged, or replaced by the logged one
+            if (replaying) {
+                Replay_Play_Input(&temp_angle, &swap, &shoot);
+            }
+            else {
+                Replay_Record_Input(temp_angle, swap, shoot);
+            }
+            
+            // Swap the spare and chambered marbles
+            if (swap) {
+                temp_colour = spare_colour;
+                spare_colour = chambered_colour;
+                chambered_colour = temp_colour;
+            }
+            
+            // Move the marble trains by one step
+            for (n = 0; n < NUM_TRAINS; n++) {
+                Move_Marble_Train(&trains[n], TRAIN_STEP);
+            }
+            
+            // Rotate the cannon based on the potentiometer angle
+            cannon_angle = temp_angle;
+            
+            // Move the airborne bullets and check them for collision with the trains
+            Step_Bullets();
+            
+            if (shoot) {
+                // Marble fired
+                // Generate a new spare colour, unless every bullet is already in flight
+                if (Fire_Bullet(cannon_angle)) {
+                    chambered_colour = spare_colour;
+                    spare_colour = Generate_Colour();
+                }
+            }
+            
+            // Win condition
+            cleared = true;
+            for (n = 0; n < NUM_TRAINS; n++) {
+                if (trains[n].length > 0) {
+                    cleared = false;
+                    
+                    // Check front marble's position
+                    if (Train_Distance(&trains[n], trains[n].length - 1) >= trains[n].track->length) {
+                        // Front marble passed the finish line, game lost
+                        // Advance to the loss screen
+                        state = YOU_DIED;
+                    }
+                }
+            }
+            if (cleared && state == GAME_ON) {
+                // Trains cleared, game won
+                // Advance to the win screen
+                state = FATALITY;
+            }
+        }
+            
+        // Hand the new state to the renderer
+        Publish_Snapshot(accumulator_us * SIM_ALPHA_ONE / SIM_STEP_US);
+        logic_cycles += HAL_Cycles() - start;
+        
+        // Sleep for a tick, the accumulator catches up on the steps that fell due
+        if (state == GAME_ON) {
+            os_dly_wait(1);
+        }
+    }
+    
+    // Advance to the win or loss screen
+    Record_End_Screen(state == FATALITY);
+    Replay_Record_End();
+    
+    // Nothing left to do on the end screen
+    os_tsk_delete_self();
+}
+
+// LCD graphics rendering task
+__task void LCD_Display() {
+    int cur = 0;
+    bool cleared = false;
+    char drawn_score_str[SCORE_DIGITS + 1] = "";
+    Frame_Snapshot *snap;
+    uint32_t start, logic_seen = 0, ops_seen = 0, waited;
+    bool screen;
+    
+    // Initialize LCD, sleeping on pixel bursts instead of spinning
+    GLCD_Init();
+    GLCD_SetDoneCallback(LCD_Burst_Done);
+    GLCD_SetWaitHook(LCD_Burst_Wait);
+    GLCD_Clear(BACKGROUND_COLOUR);
+    GLCD_SetBackColor(BACKGROUND_COLOUR);
+    GLCD_SetTextColor(TEXT_COLOUR);
+        
+    // Graphics loop
+    for(ever) {
+        start = HAL_Cycles();
+        waited = lcd_wait_cycles;
+        
+        // Draw the screens recorded by the game logic
+        // Done before taking the snapshot, which the game logic publishes before recording an end screen
+        screen = LCD_Replay();
+        cleared |= screen;
+        if (cleared) {
+            // The game logic runs while the clear is streamed
+            GLCD_Wait();
+            cleared = false;
+            
+            // Nothing from the previous frame is left on screen
+            num_sprites[cur] = 0;
+            drawn_score_str[0] = '\0';
+        }
+        
+        // Render the latest game state, only ever read from the snapshot
+        snap = Acquire_Snapshot();
+        screen |= (snap->state != GAME_ON);
+        if (snap->state == GAME_ON) {
+            cur ^= 1;
+            cleared = Render_Frame(snap, cur, drawn_score_str);
+        }
+        
+        // Report the frame's own work and the game logic's since the last one, not the sleeps
+        HAL_Frame_Done(HAL_Cycles() - start - (lcd_wait_cycles - waited) + (logic_cycles - logic_seen),
+                       logic_ops - ops_seen, screen);
+        logic_seen = logic_cycles;
+        ops_seen = logic_ops;
+        
+        // Sleep until the game logic publishes or records something new
+        if (!cleared) {
+            os_evt_wait_or(EVT_LCD_FRAME, 0xFFFF);
+        }
+    }
+}
+
+#ifdef REPLAY_RECORD
+// Input log output task, only built with REPLAY_RECORD as the board's log output may block
+// Drains the recorded session to the board's log output, a little at a time
+__task void Replay_Output() {
+    uint8_t chunk[REPLAY_CHUNK];
+    uint32_t n;
+    
+    HAL_Log_Init();
+    
+    os_itv_set(REPLAY_INTERVAL);
+    for(ever) {
+        while ((n = Replay_Drain(chunk, sizeof(chunk))) > 0) {
+            HAL_Log_Write(chunk, n);
+        }
+        
+        os_itv_wait();
+    }
+}
+#endif
+
+// LED display task
+// Switches on two LEDs, from right to left, for each multiplier
+__task void LED_Output() {
+    // Initialize LEDs
+    HAL_LED_Init();
+    
+    // Display the score multiplier on the LEDs whenever it changes
+    for(ever) {
+        os_mut_wait(&mut_LED, 0xFFFF); // --------------------------------------
+        HAL_LED_Multiplier(score_multiplier);
+        os_mut_release(&mut_LED); // -------------------------------------------
+        
+        os_evt_wait_or(EVT_LED_UPDATE, 0xFFFF);
+    }
+}
+    
+// Parent task for initialization and start-up
+__task void Startup_Task() {
+    // Initialize semaphores
+    os_mut_init(&mut_LED);
+    os_mut_init(&mut_pot);
+    os_mut_init(&mut_joy);
+    os_mut_init(&mut_list);
+    
+    // Start all tasks, none run before this task deletes itself
+    os_tsk_create(Potentiometer_Read, 1);
+    os_tsk_create(Joystick_Read, 1);
+    tsk_game = os_tsk_create(Game_Logic, 1);
+    tsk_LCD = os_tsk_create(LCD_Display, 1);
+    tsk_LED = os_tsk_create(LED_Output, 1);
+#ifdef REPLAY_RECORD
+    os_tsk_create(Replay_Output, 1);
+#endif
+    
+    // Delete self
+    os_tsk_delete_self();
+}
+
+// Main ----------------------------------------------------------------------------------------------------------------
+int main() {
+    // Start the frame cost counter
+    HAL_Cycles_Init();
+    
+    // Initialize interrupts
+    HAL_Button_Init(Button_Pressed);
+    
+    // Start the start-up task
+    os_sys_init(Startup_Task);
+    return 0;
+}
+
+
+
+
+
@@ -0,0 +1,82 @@
+/******************************************************************************/
+/* repeat.h: Macro repetition for generating tables at compile time           */
+/*   REPEAT_ROWS(n, m, ...) expands to m(..., 0) m(..., 1) ... m(..., n-1)    */
+/*   REPEAT_COLS is the same, so that the two can be nested                   */
+/*   n must be a literal (or a macro expanding to one) between 1 and 32       */
+/******************************************************************************/
+
+#ifndef _REPEAT_H
+#define _REPEAT_H
+
+#define REPEAT_ROWS(n, m, ...)  REPEAT_ROWS_(n, m, __VA_ARGS__)
+#define REPEAT_ROWS_(n, m, ...) REPEAT_ROWS_##n(m, __VA_ARGS__)
+#define REPEAT_COLS(n, m, ...)  REPEAT_COLS_(n, m, __VA_ARGS__)
+#define REPEAT_COLS_(n, m, ...) REPEAT_COLS_##n(m, __VA_ARGS__)
+
+#define REPEAT_ROWS_1(m, ...)   m(__VA_ARGS__, 0)
+#define REPEAT_ROWS_2(m, ...)   REPEAT_ROWS_1(m, __VA_ARGS__) m(__VA_ARGS__, 1)
+#define REPEAT_ROWS_3(m, ...)   REPEAT_ROWS_2(m, __VA_ARGS__) m(__VA_ARGS__, 2)
+#define REPEAT_ROWS_4(m, ...)   REPEAT_ROWS_3(m, __VA_ARGS__) m(__VA_ARGS__, 3)
+#define REPEAT_ROWS_5(m, ...)   REPEAT_ROWS_4(m, __VA_ARGS__) m(__VA_ARGS__, 4)
+#define REPEAT_ROWS_6(m, ...)   REPEAT_ROWS_5(m, __VA_ARGS__) m(__VA_ARGS__, 5)
+#define REPEAT_ROWS_7(m, ...)   REPEAT_ROWS_6(m, __VA_ARGS__) m(__VA_ARGS__, 6)
+#define REPEAT_ROWS_8(m, ...)   REPEAT_ROWS_7(m, __VA_ARGS__) m(__VA_ARGS__, 7)
+#define REPEAT_ROWS_9(m, ...)   REPEAT_ROWS_8(m, __VA_ARGS__) m(__VA_ARGS__, 8)
+#define REPEAT_ROWS_10(m, ...)  REPEAT_ROWS_9(m, __VA_ARGS__) m(__VA_ARGS__, 9)
+#define REPEAT_ROWS_11(m, ...)  REPEAT_ROWS_10(m, __VA_ARGS__) m(__VA_ARGS__, 10)
+#define REPEAT_ROWS_12(m, ...)  REPEAT_ROWS_11(m, __VA_ARGS__) m(__VA_ARGS__, 11)
+#define REPEAT_ROWS_13(m, ...)  REPEAT_ROWS_12(m, __VA_ARGS__) m(__VA_ARGS__, 12)
+#define REPEAT_ROWS_14(m, ...)  REPEAT_ROWS_13(m, __VA_ARGS__) m(__VA_ARGS__, 13)
+#define REPEAT_ROWS_15(m, ...)  REPEAT_ROWS_14(m, __VA_ARGS__) m(__VA_ARGS__, 14)
+#define REPEAT_ROWS_16(m, ...)  REPEAT_ROWS_15(m, __VA_ARGS__) m(__VA_ARGS__, 15)
+#define REPEAT_ROWS_17(m, ...)  REPEAT_ROWS_16(m, __VA_ARGS__) m(__VA_ARGS__, 16)
+#define REPEAT_ROWS_18(m, ...)  REPEAT_ROWS_17(m, __VA_ARGS__) m(__VA_ARGS__, 17)
+#define REPEAT_ROWS_19(m, ...)  REPEAT_ROWS_18(m, __VA_ARGS__) m(__VA_ARGS__, 18)
+#define REPEAT_ROWS_20(m, ...)  REPEAT_ROWS_19(m, __VA_ARGS__) m(__VA_ARGS__, 19)
+#define REPEAT_ROWS_21(m, ...)  REPEAT_ROWS_20(m, __VA_ARGS__) m(__VA_ARGS__, 20)
+#define REPEAT_ROWS_22(m, ...)  REPEAT_ROWS_21(m, __VA_ARGS__) m(__VA_ARGS__, 21)
+#define REPEAT_ROWS_23(m, ...)  REPEAT_ROWS_22(m, __VA_ARGS__) m(__VA_ARGS__, 22)
+#define REPEAT_ROWS_24(m, ...)  REPEAT_ROWS_23(m, __VA_ARGS__) m(__VA_ARGS__, 23)
+#define REPEAT_ROWS_25(m, ...)  REPEAT_ROWS_24(m, __VA_ARGS__) m(__VA_ARGS__, 24)
+#define REPEAT_ROWS_26(m, ...)  REPEAT_ROWS_25(m, __VA_ARGS__) m(__VA_ARGS__, 25)
+#define REPEAT_ROWS_27(m, ...)  REPEAT_ROWS_26(m, __VA_ARGS__) m(__VA_ARGS__, 26)
+#define REPEAT_ROWS_28(m, ...)  REPEAT_ROWS_27(m, __VA_ARGS__) m(__VA_ARGS__, 27)
+#define REPEAT_ROWS_29(m, ...)  REPEAT_ROWS_28(m, __VA_ARGS__) m(__VA_ARGS__, 28)
+#define REPEAT_ROWS_30(m, ...)  REPEAT_ROWS_29(m, __VA_ARGS__) m(__VA_ARGS__, 29)
+#define REPEAT_ROWS_31(m, ...)  REPEAT_ROWS_30(m, __VA_ARGS__) m(__VA_ARGS__, 30)
+#define REPEAT_ROWS_32(m, ...)  REPEAT_ROWS_31(m, __VA_ARGS__) m(__VA_ARGS__, 31)
+
+#define REPEAT_COLS_1(m, ...)   m(__VA_ARGS__, 0)
+#define REPEAT_COLS_2(m, ...)   REPEAT_COLS_1(m, __VA_ARGS__) m(__VA_ARGS__, 1)
+#define REPEAT_COLS_3(m, ...)   REPEAT_COLS_2(m, __VA_ARGS__) m(__VA_ARGS__, 2)
+#define REPEAT_COLS_4(m, ...)   REPEAT_COLS_3(m, __VA_ARGS__) m(__VA_ARGS__, 3)
+#define REPEAT_COLS_5(m, ...)   REPEAT_COLS_4(m, __VA_ARGS__) m(__VA_ARGS__, 4)
+#define REPEAT_COLS_6(m, ...)   REPEAT_COLS_5(m, __VA_ARGS__) m(__VA_ARGS__, 5)
+#define REPEAT_COLS_7(m, ...)   REPEAT_COLS_6(m, __VA_ARGS__) m(__VA_ARGS__, 6)
+#define REPEAT_COLS_8(m, ...)   REPEAT_COLS_7(m, __VA_ARGS__) m(__VA_ARGS__, 7)
+#define REPEAT_COLS_9(m, ...)   REPEAT_COLS_8(m, __VA_ARGS__) m(__VA_ARGS__, 8)
+#define REPEAT_COLS_10(m, ...)  REPEAT_COLS_9(m, __VA_ARGS__) m(__VA_ARGS__, 9)
+#define REPEAT_COLS_11(m, ...)  REPEAT_COLS_10(m, __VA_ARGS__) m(__VA_ARGS__, 10)
+#define REPEAT_COLS_12(m, ...)  REPEAT_COLS_11(m, __VA_ARGS__) m(__VA_ARGS__, 11)
+#define REPEAT_COLS_13(m, ...)  REPEAT_COLS_12(m, __VA_ARGS__) m(__VA_ARGS__, 12)
+#define REPEAT_COLS_14(m, ...)  REPEAT_COLS_13(m, __VA_ARGS__) m(__VA_ARGS__, 13)
+#define REPEAT_COLS_15(m, ...)  REPEAT_COLS_14(m, __VA_ARGS__) m(__VA_ARGS__, 14)
+#define REPEAT_COLS_16(m, ...)  REPEAT_COLS_15(m, __VA_ARGS__) m(__VA_ARGS__, 15)
+#define REPEAT_COLS_17(m, ...)  REPEAT_COLS_16(m, __VA_ARGS__) m(__VA_ARGS__, 16)
+#define REPEAT_COLS_18(m, ...)  REPEAT_COLS_17(m, __VA_ARGS__) m(__VA_ARGS__, 17)
+#define REPEAT_COLS_19(m, ...)  REPEAT_COLS_18(m, __VA_ARGS__) m(__VA_ARGS__, 18)
+#define REPEAT_COLS_20(m, ...)  REPEAT_COLS_19(m, __VA_ARGS__) m(__VA_ARGS__, 19)
+#define REPEAT_COLS_21(m, ...)  REPEAT_COLS_20(m, __VA_ARGS__) m(__VA_ARGS__, 20)
+#define REPEAT_COLS_22(m, ...)  REPEAT_COLS_21(m, __VA_ARGS__) m(__VA_ARGS__, 21)
+#define REPEAT_COLS_23(m, ...)  REPEAT_COLS_22(m, __VA_ARGS__) m(__VA_ARGS__, 22)
+#define REPEAT_COLS_24(m, ...)  REPEAT_COLS_23(m, __VA_ARGS__) m(__VA_ARGS__, 23)
+#define REPEAT_COLS_25(m, ...)  REPEAT_COLS_24(m, __VA_ARGS__) m(__VA_ARGS__, 24)
+#define REPEAT_COLS_26(m, ...)  REPEAT_COLS_25(m, __VA_ARGS__) m(__VA_ARGS__, 25)
+#define REPEAT_COLS_27(m, ...)  REPEAT_COLS_26(m, __VA_ARGS__) m(__VA_ARGS__, 26)
+#define REPEAT_COLS_28(m, ...)  REPEAT_COLS_27(m, __VA_ARGS__) m(__VA_ARGS__, 27)
+#define REPEAT_COLS_29(m, ...)  REPEAT_COLS_28(m, __VA_ARGS__) m(__VA_ARGS__, 28)
+#define REPEAT_COLS_30(m, ...)  REPEAT_COLS_29(m, __VA_ARGS__) m(__VA_ARGS__, 29)
+#define REPEAT_COLS_31(m, ...)  REPEAT_COLS_30(m, __VA_ARGS__) m(__VA_ARGS__, 30)
+#define REPEAT_COLS_32(m, ...)  REPEAT_COLS_31(m, __VA_ARGS__) m(__VA_ARGS__, 31)
+
+#endif /* _REPEAT_H */
@@ -0,0 +1,242 @@
+/******************************************************************************/
+/* replay.c: Input log for recording and replaying game sessions              */
+/*   The recorder is the only writer of the ring tail and the draining task   */
+/*   the only writer of the head, so neither needs a lock. A full ring stops  */
+/*   the recording rather than dropping bytes from the middle of it, the log  */
+/*   then ends early and plays back up to that point. The recorder is only    */
+/*   built with REPLAY_RECORD, so playback-only builds carry no ring.         */
+/******************************************************************************/
+
+#include "replay.h"
+#include "hal.h"
+
+/*---------------------------- Global variables ------------------------------*/
+
+#ifdef REPLAY_RECORD
+static uint8_t           ring[REPLAY_RING_SIZE];
+static volatile uint32_t ring_head;             /* Next byte to drain         */
+static volatile uint32_t ring_tail;             /* Next free byte             */
+static int               recording, overflow;
+static uint32_t          rec_frame_us;          /* Previous frame length      */
+static int               rec_angle;
+#endif
+
+static const uint8_t    *play_log;
+static uint32_t          play_length, play_pos;
+static uint32_t          play_frame_us;
+static int               play_angle;
+
+/************************ Local auxiliary functions ***************************/
+
+#ifdef REPLAY_RECORD
+/*******************************************************************************
+* Append bytes to the recording ring, all of them or none                      *
+*   Parameter:    data:   bytes to append                                      *
+*                 n:      number of bytes                                      *
+*******************************************************************************/
+
+static void ring_put (const uint8_t *data, uint32_t n) {
+  uint32_t i;
+
+  if (!recording) {
+    return;
+  }
+  if (REPLAY_RING_SIZE - (ring_tail - ring_head) < n) {
+    recording = 0;
+    overflow  = 1;
+    return;
+  }
+  for (i = 0; i < n; i++) {
+    ring[(ring_tail + i) & (REPLAY_RING_SIZE - 1)] = data[i];
+  }
+  HAL_Barrier();                        /* Bytes stored before they are shown */
+  ring_tail += n;
+}
+#endif
+
+/*******************************************************************************
+* Take the next byte of the log being played                                   *
+*   Return:               the byte, REPLAY_END past the end of the log         *
+*******************************************************************************/
+
+static uint8_t play_byte (void) {
+  return (play_pos < play_length) ? play_log[play_pos++] : REPLAY_END;
+}
+
+/************************ Exported functions **********************************/
+
+#ifdef REPLAY_RECORD
+/*******************************************************************************
+* Start recording a session                                                    *
+*   Parameter:    seed:   random seed the session starts from                  *
+*******************************************************************************/
+
+void Replay_Record_Start (uint16_t seed) {
+  uint8_t header[5] = { 'M', 'K', REPLAY_VERSION, 0, 0 };
+
+  header[3]    = seed & 0xFF;
+  header[4]    = seed >> 8;
+  recording    = 1;
+  overflow     = 0;
+  rec_frame_us = 0;
+  rec_angle    = 0;
+  ring_put(header, sizeof(header));
+}
+
+/*******************************************************************************
+* Record the time a game logic frame covers                                    *
+*   Parameter:    elapsed_us: microseconds since the previous frame            *
+*******************************************************************************/
+
+void Replay_Record_Frame (uint32_t elapsed_us) {
+  uint8_t  buf[6];
+  uint32_t n = 0;
+
+  if (elapsed_us == rec_frame_us && elapsed_us != 0) {
+    buf[n++] = REPLAY_REPEAT;
+  } else {
+    rec_frame_us = elapsed_us;
+    buf[n++] = REPLAY_FRAME;
+    do {
+      buf[n] = elapsed_us & 0x7F;
+      elapsed_us >>= 7;
+      buf[n++] |= elapsed_us ? 0x80 : 0;
+    } while (elapsed_us);
+  }
+  ring_put(buf, n);
+}
+
+/*******************************************************************************
+* Record the inputs one simulation step takes, nothing if none changed         *
+*   Parameter:    angle:  cannon angle in degrees                              *
+*                 swap:   non-zero if the marbles were swapped                 *
+*                 shoot:  non-zero if a marble was fired                       *
+*******************************************************************************/
+
+void Replay_Record_Input (int angle, int swap, int shoot) {
+  uint8_t buf[2];
+
+  buf[0] = REPLAY_INPUT | (swap ? REPLAY_SWAP : 0) | (shoot ? REPLAY_SHOOT : 0);
+  buf[1] = (uint8_t)(int8_t)angle;
+  if (angle != rec_angle) {
+    buf[0]   |= REPLAY_ANGLE;
+    rec_angle = angle;
+  }
+  if (buf[0] != REPLAY_INPUT) {
+    ring_put(buf, (buf[0] & REPLAY_ANGLE) ? 2 : 1);
+  }
+}
+
+/*******************************************************************************
+* End the recording                                                            *
+*******************************************************************************/
+
+void Replay_Record_End (void) {
+  uint8_t end = REPLAY_END;
+
+  ring_put(&end, 1);
+  recording = 0;
+}
+
+/*******************************************************************************
+* Take recorded bytes out of the ring, from the draining task                  *
+*   Parameter:    buf:    where to copy them                                   *
+*                 max:    most bytes to take                                   *
+*   Return:               bytes taken                                          *
+*******************************************************************************/
+
+uint32_t Replay_Drain (uint8_t *buf, uint32_t max) {
+  uint32_t n = 0, head = ring_head, tail = ring_tail;
+
+  HAL_Barrier();                        /* Bytes read only once shown         */
+  while (n < max && head != tail) {
+    buf[n++] = ring[head++ & (REPLAY_RING_SIZE - 1)];
+  }
+  HAL_Barrier();                        /* and before their space is reused   */
+  ring_head = head;
+  return n;
+}
+
+/*******************************************************************************
+* Check whether the recording stopped early on a full ring                     *
+*   Return:               non-zero if it did                                   *
+*******************************************************************************/
+
+int Replay_Overflowed (void) {
+  return overflow;
+}
+#endif
+
+/*******************************************************************************
+* Start playing a recorded session back                                        *
+*   Parameter:    log:    recorded log, NULL for none                          *
+*                 length: bytes in the log                                     *
+*                 seed:   returned random seed the session started from        *
+*   Return:               0 if there is no valid log to play                   *
+*******************************************************************************/
+
+int Replay_Play_Start (const uint8_t *log, uint32_t length, uint16_t *seed) {
+  if (log == 0 || length < 5 || log[0] != 'M' || log[1] != 'K' || log[2] != REPLAY_VERSION) {
+    play_log = 0;
+    return 0;
+  }
+  play_log      = log;
+  play_length   = length;
+  play_pos      = 5;
+  play_frame_us = 0;
+  play_angle    = 0;
+  *seed = log[3] | (log[4] << 8);
+  return 1;
+}
+
+/*******************************************************************************
+* Take the time the next recorded frame covers                                 *
+*   Parameter:    elapsed_us: returned microseconds since the previous frame   *
+*   Return:               0 at the end of the session                          *
+*******************************************************************************/
+
+int Replay_Play_Frame (uint32_t *elapsed_us) {
+  uint8_t  tag = play_byte(), b;
+  uint32_t us = 0, shift = 0;
+
+  if (tag == REPLAY_REPEAT) {
+    *elapsed_us = play_frame_us;
+    return 1;
+  }
+  if (tag != REPLAY_FRAME) {
+    return 0;
+  }
+  do {
+    b   = play_byte();
+    us |= (uint32_t)(b & 0x7F) << shift;
+    shift += 7;
+  } while ((b & 0x80) && shift < 35);
+
+  *elapsed_us = play_frame_us = us;
+  return 1;
+}
+
+/*******************************************************************************
+* Take the recorded inputs for the next simulation step                        *
+*   Parameter:    angle:  returned cannon angle in degrees                     *
+*                 swap:   returned non-zero if the marbles were swapped        *
+*                 shoot:  returned non-zero if a marble was fired              *
+*******************************************************************************/
+
+void Replay_Play_Input (int *angle, int *swap, int *shoot) {
+  uint8_t tag = (play_pos < play_length) ? play_log[play_pos] : REPLAY_END;
+
+  *swap  = 0;
+  *shoot = 0;
+  if ((tag & 0xC0) == REPLAY_INPUT) {
+    play_pos++;
+    *swap  = (tag & REPLAY_SWAP)  != 0;
+    *shoot = (tag & REPLAY_SHOOT) != 0;
+    if (tag & REPLAY_ANGLE) {
+      play_angle = (int8_t)play_byte();
+    }
+  }
+  *angle = play_angle;
+}
+
+/******************************************************************************/
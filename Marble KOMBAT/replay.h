@@ -0,0 +1,59 @@
+/******************************************************************************/
+/* replay.h: Input log for recording and replaying game sessions              */
+/*   A log is the random seed followed by the elapsed time of every game      */
+/*   logic frame and the inputs taken by each simulation step, so feeding it  */
+/*   back reproduces the session exactly. Recording goes into a RAM ring      */
+/*   that is drained by the caller, playback reads a log from memory. The     */
+/*   recorder and its ring are only built with REPLAY_RECORD, otherwise its   */
+/*   calls compile to nothing.                                                */
+/*                                                                            */
+/*   Format, multi-byte values little endian:                                 */
+/*     'M' 'K' version seed(2)          header                                */
+/*     REPLAY_FRAME  us(LEB128)         frame of us microseconds              */
+/*     REPLAY_REPEAT                    frame as long as the previous one     */
+/*     REPLAY_INPUT|flags [angle(1)]    inputs for the next step, the angle   */
+/*                                      follows only with REPLAY_ANGLE        */
+/*     REPLAY_END                       end of the session                    */
+/*   Steps without a REPLAY_INPUT record took no input.                       */
+/******************************************************************************/
+
+#ifndef _REPLAY_H
+#define _REPLAY_H
+
+#include <stdint.h>
+
+#define REPLAY_RING_SIZE    4096        /* Recording ring (bytes), power of 2 */
+#define REPLAY_VERSION      1
+
+/* Record types                                                               */
+#define REPLAY_FRAME        0x00
+#define REPLAY_REPEAT       0x01
+#define REPLAY_INPUT        0x40        /* Low bits are REPLAY_xxx flags      */
+#define REPLAY_END          0xFF
+
+/* REPLAY_INPUT flags                                                         */
+#define REPLAY_SWAP         0x01        /* Joystick swapped the marbles       */
+#define REPLAY_SHOOT        0x02        /* Button fired                       */
+#define REPLAY_ANGLE        0x04        /* Cannon angle changed               */
+
+/* Recording, from the game logic task only                                   */
+#ifdef REPLAY_RECORD
+extern void     Replay_Record_Start (uint16_t seed);
+extern void     Replay_Record_Frame (uint32_t elapsed_us);
+extern void     Replay_Record_Input (int angle, int swap, int shoot);
+extern void     Replay_Record_End   (void);
+extern uint32_t Replay_Drain        (uint8_t *buf, uint32_t max);
+extern int      Replay_Overflowed   (void);
+#else
+#define Replay_Record_Start(seed)               ((void)0)
+#define Replay_Record_Frame(elapsed_us)         ((void)0)
+#define Replay_Record_Input(angle, swap, shoot) ((void)0)
+#define Replay_Record_End()                     ((void)0)
+#endif
+
+/* Playback                                                                   */
+extern int      Replay_Play_Start   (const uint8_t *log, uint32_t length, uint16_t *seed);
+extern int      Replay_Play_Frame   (uint32_t *elapsed_us);
+extern void     Replay_Play_Input   (int *angle, int *swap, int *shoot);
+
+#endif /* _REPLAY_H */
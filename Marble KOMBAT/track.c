@@ -0,0 +1,284 @@
+/******************************************************************************/
+/* track.c: Train tracks and their arc-length tables                          */
+/*   Each track is a polyline resampled every TRACK_SAMPLE px of arc length,  */
+/*   so a distance along the track maps to a screen position with one table   */
+/*   lookup. Each cell of the screen also lists the range of distances that   */
+/*   pass within TRACK_REACH px of it, for collision queries. The tables are  */
+/*   generated by host/track_gen.py from the vertices listed with each track. */
+/******************************************************************************/
+
+#include "track.h"
+
+/*---------------------------- Global variables ------------------------------*/
+
+/* Generated by host/track_gen.py, edit the tracks there and rerun it */
+
+/* Straight down the right of the screen, vertices:
+ *   (200, 0), (200, 320) */
+
+static const short column_sample[81][2] = {
+  { 3200,     0}, { 3200,    64}, { 3200,   128}, { 3200,   192}, { 3200,   256},
+  { 3200,   320}, { 3200,   384}, { 3200,   448}, { 3200,   512}, { 3200,   576},
+  { 3200,   640}, { 3200,   704}, { 3200,   768}, { 3200,   832}, { 3200,   896},
+  { 3200,   960}, { 3200,  1024}, { 3200,  1088}, { 3200,  1152}, { 3200,  1216},
+  { 3200,  1280}, { 3200,  1344}, { 3200,  1408}, { 3200,  1472}, { 3200,  1536},
+  { 3200,  1600}, { 3200,  1664}, { 3200,  1728}, { 3200,  1792}, { 3200,  1856},
+  { 3200,  1920}, { 3200,  1984}, { 3200,  2048}, { 3200,  2112}, { 3200,  2176},
+  { 3200,  2240}, { 3200,  2304}, { 3200,  2368}, { 3200,  2432}, { 3200,  2496},
+  { 3200,  2560}, { 3200,  2624}, { 3200,  2688}, { 3200,  2752}, { 3200,  2816},
+  { 3200,  2880}, { 3200,  2944}, { 3200,  3008}, { 3200,  3072}, { 3200,  3136},
+  { 3200,  3200}, { 3200,  3264}, { 3200,  3328}, { 3200,  3392}, { 3200,  3456},
+  { 3200,  3520}, { 3200,  3584}, { 3200,  3648}, { 3200,  3712}, { 3200,  3776},
+  { 3200,  3840}, { 3200,  3904}, { 3200,  3968}, { 3200,  4032}, { 3200,  4096},
+  { 3200,  4160}, { 3200,  4224}, { 3200,  4288}, { 3200,  4352}, { 3200,  4416},
+  { 3200,  4480}, { 3200,  4544}, { 3200,  4608}, { 3200,  4672}, { 3200,  4736},
+  { 3200,  4800}, { 3200,  4864}, { 3200,  4928}, { 3200,  4992}, { 3200,  5056},
+  { 3200,  5120}
+};
+
+static const short column_cell[TRACK_CELLS_Y * TRACK_CELLS_X][2] = {
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {   0,   52}, {   0,   56}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {  12,   84}, {   8,   88}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {  44,  116}, {  40,  120}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {  76,  148}, {  72,  152}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, { 108,  180}, { 104,  184}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, { 140,  212}, { 136,  216}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, { 172,  244}, { 168,  248}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, { 204,  276}, { 200,  280}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, { 236,  308}, { 232,  312}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, { 268,  324}, { 264,  324}, {   0,   -1}
+};
+
+/* 320.00 px long */
+const Track track_column = { column_sample, 81, column_cell, 20971520 };
+
+/* Zig-zag across the right two thirds of the screen, vertices:
+ *   (200, 0), (200, 40), (110, 100), (210, 160), (110, 220), (200, 280),
+ *   (200, 320) */
+
+static const short zigzag_sample[134][2] = {
+  { 3200,     0}, { 3200,    64}, { 3200,   128}, { 3200,   192}, { 3200,   256},
+  { 3200,   320}, { 3200,   384}, { 3200,   448}, { 3200,   512}, { 3200,   576},
+  { 3200,   640}, { 3147,   676}, { 3093,   711}, { 3040,   747}, { 2987,   782},
+  { 2934,   818}, { 2880,   853}, { 2827,   889}, { 2774,   924}, { 2721,   960},
+  { 2667,   995}, { 2614,  1031}, { 2561,  1066}, { 2508,  1102}, { 2454,  1137},
+  { 2401,  1173}, { 2348,  1208}, { 2295,  1244}, { 2241,  1279}, { 2188,  1315},
+  { 2135,  1350}, { 2082,  1386}, { 2028,  1421}, { 1975,  1457}, { 1922,  1492},
+  { 1869,  1528}, { 1815,  1563}, { 1762,  1599}, { 1813,  1632}, { 1867,  1664},
+  { 1922,  1697}, { 1977,  1730}, { 2032,  1763}, { 2087,  1796}, { 2142,  1829},
+  { 2197,  1862}, { 2252,  1895}, { 2307,  1928}, { 2361,  1961}, { 2416,  1994},
+  { 2471,  2027}, { 2526,  2060}, { 2581,  2093}, { 2636,  2125}, { 2691,  2158},
+  { 2746,  2191}, { 2800,  2224}, { 2855,  2257}, { 2910,  2290}, { 2965,  2323},
+  { 3020,  2356}, { 3075,  2389}, { 3130,  2422}, { 3185,  2455}, { 3239,  2488},
+  { 3294,  2521}, { 3349,  2554}, { 3316,  2586}, { 3261,  2619}, { 3206,  2652},
+  { 3151,  2685}, { 3096,  2718}, { 3042,  2751}, { 2987,  2784}, { 2932,  2817},
+  { 2877,  2850}, { 2822,  2883}, { 2767,  2916}, { 2712,  2949}, { 2657,  2982},
+  { 2602,  3015}, { 2548,  3047}, { 2493,  3080}, { 2438,  3113}, { 2383,  3146},
+  { 2328,  3179}, { 2273,  3212}, { 2218,  3245}, { 2163,  3278}, { 2109,  3311},
+  { 2054,  3344}, { 1999,  3377}, { 1944,  3410}, { 1889,  3443}, { 1834,  3476},
+  { 1779,  3508}, { 1795,  3543}, { 1848,  3579}, { 1901,  3614}, { 1954,  3650},
+  { 2008,  3685}, { 2061,  3721}, { 2114,  3756}, { 2167,  3792}, { 2221,  3827},
+  { 2274,  3863}, { 2327,  3898}, { 2380,  3934}, { 2434,  3969}, { 2487,  4005},
+  { 2540,  4040}, { 2593,  4076}, { 2647,  4111}, { 2700,  4147}, { 2753,  4182},
+  { 2806,  4218}, { 2860,  4253}, { 2913,  4289}, { 2966,  4324}, { 3019,  4360},
+  { 3073,  4395}, { 3126,  4431}, { 3179,  4466}, { 3200,  4519}, { 3200,  4583},
+  { 3200,  4647}, { 3200,  4711}, { 3200,  4775}, { 3200,  4839}, { 3200,  4903},
+  { 3200,  4967}, { 3200,  5031}, { 3200,  5095}, { 3200,  5120}
+};
+
+static const short zigzag_cell[TRACK_CELLS_Y * TRACK_CELLS_X][2] = {
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {   0,   64}, {   0,   60}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {  64,  120}, {  12,  108}, {   8,   76}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, { 140,  156}, { 100,  180},
+  {  64,  180}, {  44,  116}, {  44,   76}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, { 140,  156}, { 112,  196},
+  { 104,  228}, { 180,  244}, { 224,  244}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, { 160,  192},
+  { 164,  232}, { 184,  304}, { 220,  300}, { 256,  272},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, { 336,  368},
+  { 296,  368}, { 224,  348}, { 228,  312}, { 256,  272},
+  {   0,   -1}, {   0,   -1}, { 372,  392}, { 336,  420},
+  { 304,  428}, { 288,  348}, { 288,  308}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, { 372,  392}, { 352,  428},
+  { 348,  464}, { 416,  484}, { 456,  484}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, { 412,  420},
+  { 408,  468}, { 420,  516}, { 452,  520}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, { 464,  536}, { 468,  536}, {   0,   -1}
+};
+
+/* 529.57 px long */
+const Track track_zigzag = { zigzag_sample, 134, zigzag_cell, 34705975 };
+
+/* Two turns spiralling in to the centre of the right of the screen, vertices:
+ *   (155, 0), (155, 90), then every 15 degrees clockwise from the top around
+ *   (155, 165) with the radius shrinking from 75 to 25 over the two turns */
+
+static const short spiral_sample[181][2] = {
+  { 2480,     0}, { 2480,    64}, { 2480,   128}, { 2480,   192}, { 2480,   256},
+  { 2480,   320}, { 2480,   384}, { 2480,   448}, { 2480,   512}, { 2480,   576},
+  { 2480,   640}, { 2480,   704}, { 2480,   768}, { 2480,   832}, { 2480,   896},
+  { 2480,   960}, { 2480,  1024}, { 2480,  1088}, { 2480,  1152}, { 2480,  1216},
+  { 2480,  1280}, { 2480,  1344}, { 2480,  1408}, { 2511,  1446}, { 2574,  1458},
+  { 2637,  1469}, { 2700,  1481}, { 2763,  1493}, { 2823,  1514}, { 2881,  1542},
+  { 2938,  1570}, { 2996,  1597}, { 3054,  1625}, { 3104,  1664}, { 3152,  1706},
+  { 3201,  1748}, { 3249,  1789}, { 3297,  1832}, { 3333,  1885}, { 3369,  1938},
+  { 3405,  1991}, { 3441,  2044}, { 3471,  2100}, { 3492,  2160}, { 3513,  2221},
+  { 3534,  2281}, { 3555,  2341}, { 3563,  2405}, { 3567,  2468}, { 3572,  2532},
+  { 3577,  2596}, { 3576,  2660}, { 3564,  2723}, { 3552,  2785}, { 3540,  2848},
+  { 3528,  2911}, { 3503,  2969}, { 3475,  3027}, { 3447,  3085}, { 3419,  3142},
+  { 3384,  3196}, { 3343,  3244}, { 3301,  3292}, { 3259,  3341}, { 3215,  3387},
+  { 3162,  3423}, { 3109,  3459}, { 3056,  3495}, { 3003,  3531}, { 2943,  3553},
+  { 2883,  3574}, { 2822,  3595}, { 2762,  3616}, { 2699,  3625}, { 2635,  3629},
+  { 2571,  3634}, { 2508,  3638}, { 2444,  3633}, { 2382,  3621}, { 2319,  3608},
+  { 2256,  3596}, { 2196,  3575}, { 2138,  3547}, { 2081,  3519}, { 2024,  3490},
+  { 1971,  3455}, { 1923,  3413}, { 1875,  3370}, { 1827,  3328}, { 1787,  3279},
+  { 1751,  3226}, { 1716,  3173}, { 1680,  3119}, { 1656,  3060}, { 1636,  3000},
+  { 1615,  2939}, { 1595,  2878}, { 1591,  2815}, { 1587,  2751}, { 1583,  2687},
+  { 1583,  2623}, { 1596,  2561}, { 1609,  2498}, { 1622,  2435}, { 1645,  2376},
+  { 1673,  2319}, { 1702,  2261}, { 1731,  2205}, { 1774,  2157}, { 1816,  2109},
+  { 1859,  2061}, { 1907,  2020}, { 1961,  1985}, { 2015,  1950}, { 2069,  1917},
+  { 2130,  1897}, { 2190,  1877}, { 2251,  1857}, { 2314,  1849}, { 2378,  1845},
+  { 2442,  1842}, { 2505,  1845}, { 2568,  1859}, { 2631,  1872}, { 2692,  1888},
+  { 2749,  1917}, { 2806,  1947}, { 2863,  1976}, { 2910,  2019}, { 2958,  2062},
+  { 3005,  2105}, { 3041,  2158}, { 3076,  2212}, { 3110,  2266}, { 3132,  2326},
+  { 3151,  2387}, { 3170,  2448}, { 3175,  2511}, { 3177,  2575}, { 3180,  2639},
+  { 3166,  2702}, { 3152,  2764}, { 3135,  2826}, { 3106,  2882}, { 3076,  2939},
+  { 3040,  2991}, { 2997,  3038}, { 2953,  3085}, { 2902,  3123}, { 2848,  3157},
+  { 2793,  3190}, { 2732,  3208}, { 2670,  3226}, { 2608,  3237}, { 2544,  3238},
+  { 2480,  3240}, { 2418,  3225}, { 2355,  3210}, { 2297,  3186}, { 2241,  3155},
+  { 2187,  3121}, { 2141,  3077}, { 2095,  3032}, { 2061,  2978}, { 2028,  2923},
+  { 2006,  2864}, { 1989,  2802}, { 1981,  2739}, { 1980,  2675}, { 1987,  2612},
+  { 2004,  2550}, { 2027,  2491}, { 2059,  2436}, { 2098,  2385}, { 2143,  2340},
+  { 2195,  2303}, { 2250,  2272}, { 2311,  2253}, { 2373,  2238}, { 2437,  2239},
+  { 2480,  2240}
+};
+
+static const short spiral_cell[TRACK_CELLS_Y * TRACK_CELLS_X][2] = {
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   56}, {   0,   52}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   8,   88}, {  12,   84}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {  40,  488}, {  44,  488}, { 104,  152}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, { 416,  440}, { 416,  708},
+  {  72,  724}, {  76,  724}, { 104,  540}, { 144,  188},
+  {   0,   -1}, {   0,   -1}, { 384,  440}, { 380,  712},
+  { 424,  724}, { 140,  724}, { 136,  572}, { 148,  220},
+  {   0,   -1}, {   0,   -1}, { 356,  424}, { 344,  704},
+  { 592,  724}, { 244,  636}, { 176,  604}, { 176,  248},
+  {   0,   -1}, {   0,   -1}, { 348,  392}, { 312,  668},
+  { 280,  668}, { 236,  640}, { 208,  604}, { 208,  252},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, { 312,  360},
+  { 280,  352}, { 248,  324}, { 244,  292}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1},
+  {   0,   -1}, {   0,   -1}, {   0,   -1}, {   0,   -1}
+};
+
+/* 718.67 px long */
+const Track track_spiral = { spiral_sample, 181, spiral_cell, 47099066 };
+
+/************************ Exported functions **********************************/
+
+/*******************************************************************************
+* Screen position at a distance along a track                                  *
+*   Parameter:    track:  track to follow                                      *
+*                 d:      distance along the track, clamped to its ends        *
+*                 x, y:   returned position                                    *
+*******************************************************************************/
+
+void Track_Point (const Track *track, Fixed d, Fixed *x, Fixed *y) {
+  unsigned int i;
+  Fixed        frac;
+
+  if (d < 0) {
+    d = 0;
+  }
+  i    = d / TO_FIXED(TRACK_SAMPLE);
+  frac = d % TO_FIXED(TRACK_SAMPLE) / TRACK_SAMPLE;
+  if (i >= track->num_samples - 1) {
+    i    = track->num_samples - 2;
+    frac = FIXED_ONE;
+  }
+
+  *x = (track->sample[i][0] << (FIXED_SHIFT - TRACK_FRAC)) +
+       (track->sample[i + 1][0] - track->sample[i][0]) * (frac >> TRACK_FRAC);
+  *y = (track->sample[i][1] << (FIXED_SHIFT - TRACK_FRAC)) +
+       (track->sample[i + 1][1] - track->sample[i][1]) * (frac >> TRACK_FRAC);
+}
+
+/*******************************************************************************
+* Direction of a track at a distance along it                                  *
+*   Parameter:    track:  track to follow                                      *
+*                 d:      distance along the track, clamped to its ends        *
+*                 dx, dy: returned direction, TRACK_SAMPLE px long in 1/16 px  *
+*******************************************************************************/
+
+void Track_Direction (const Track *track, Fixed d, int *dx, int *dy) {
+  unsigned int i = (d < 0) ? 0 : d / TO_FIXED(TRACK_SAMPLE);
+
+  if (i >= track->num_samples - 1) {
+    i = track->num_samples - 2;
+  }
+  *dx = track->sample[i + 1][0] - track->sample[i][0];
+  *dy = track->sample[i + 1][1] - track->sample[i][1];
+}
+
+/*******************************************************************************
+* Range of distances along a track that pass near a box                        *
+*   Parameter:    track:  track to follow                                      *
+*                 x0, y0: one corner of the box on the screen                  *
+*                 x1, y1: the opposite corner, the same point for a point      *
+*                 d_min, d_max: returned range, anything within TRACK_REACH px *
+*                         of the box lies between them                         *
+*   Return:               0 if the track does not pass near the box            *
+*******************************************************************************/
+
+int Track_Near (const Track *track, Fixed x0, Fixed y0,
+                Fixed x1, Fixed y1, Fixed *d_min, Fixed *d_max) {
+  int cx0 = FIXED_INT((x0 < x1) ? x0 : x1) / TRACK_CELL;
+  int cx1 = FIXED_INT((x0 < x1) ? x1 : x0) / TRACK_CELL;
+  int cy0 = FIXED_INT((y0 < y1) ? y0 : y1) / TRACK_CELL;
+  int cy1 = FIXED_INT((y0 < y1) ? y1 : y0) / TRACK_CELL;
+  int cx, cy, low = 0x7FFF, high = -1;
+  const short *cell;
+
+  if (cx0 < 0)              cx0 = 0;
+  if (cy0 < 0)              cy0 = 0;
+  if (cx1 >= TRACK_CELLS_X) cx1 = TRACK_CELLS_X - 1;
+  if (cy1 >= TRACK_CELLS_Y) cy1 = TRACK_CELLS_Y - 1;
+
+  for (cy = cy0; cy <= cy1; cy++) {
+    for (cx = cx0; cx <= cx1; cx++) {
+      cell = track->cell[cy * TRACK_CELLS_X + cx];
+      if (cell[1] < cell[0]) {
+        continue;
+      }
+      if (cell[0] < low)  low  = cell[0];
+      if (cell[1] > high) high = cell[1];
+    }
+  }
+  if (high < low) {
+    return 0;
+  }
+
+  *d_min = TO_FIXED(low);
+  *d_max = TO_FIXED(high);
+  return 1;
+}
+
+/******************************************************************************/
@@ -0,0 +1,35 @@
+/******************************************************************************/
+/* track.h: Train tracks with arc-length lookup tables                        */
+/*   Distances along a track are Q16.16 px from its start. Table positions    */
+/*   are in 1/(1 << TRACK_FRAC) px so they fit in a short.                    */
+/******************************************************************************/
+
+#ifndef _TRACK_H
+#define _TRACK_H
+
+#include "fixed.h"
+
+#define TRACK_SAMPLE    4               /* Arc length between samples (px)    */
+#define TRACK_FRAC      4               /* Fraction bits of sample positions  */
+#define TRACK_CELL      32              /* Side of a collision cell (px)      */
+#define TRACK_CELLS_X   8               /* Cells across the 240 px screen     */
+#define TRACK_CELLS_Y   10              /* Cells down the 320 px screen       */
+#define TRACK_REACH     16              /* Cell margin covered by its range   */
+
+typedef struct {
+  const short (*sample)[2];             /* x, y every TRACK_SAMPLE px         */
+  unsigned int  num_samples;
+  const short (*cell)[2];               /* Distance range near each cell (px) */
+  Fixed         length;                 /* Distance to the end of the track   */
+} Track;
+
+extern const Track track_column;
+extern const Track track_zigzag;
+extern const Track track_spiral;
+
+extern void Track_Point     (const Track *track, Fixed d, Fixed *x, Fixed *y);
+extern void Track_Direction (const Track *track, Fixed d, int *dx, int *dy);
+extern int  Track_Near      (const Track *track, Fixed x0, Fixed y0,
+                             Fixed x1, Fixed y1, Fixed *d_min, Fixed *d_max);
+
+#endif /* _TRACK_H */